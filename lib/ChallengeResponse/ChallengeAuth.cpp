@@ -1,24 +1,25 @@
 #include "ChallengeAuth.h"
+#include "PeerKeys.h"
+#include "SecureRandom.h"
 
 void handleAuthChallenge(NodeState *peer, const String &selfId, uint32_t ttl)
 {
-
-    randomSeed(peer->sharedSessionKey + peer->messageCount);
-    uint32_t challenge = random(100000, 999999);
+    // Fresh from the node generator: reseeding random() from the key and counter made
+    // challenges repeat whenever the counter did (e.g. after every reset to 0)
+    uint32_t challenge = secureRandomRange(100000, 999999);
 
     peer->challenge = challenge;
 
     String challengeStr = String(challenge);
-    String encryptedChallenge = encryptString(challengeStr, peer->sharedSessionKey, peer->messageCount);
+    String encryptedChallenge = encryptForPeer(peer, challengeStr, peer->messageCount,
+                                               createAssociatedData("CHAL", selfId, peerId(peer), peer->messageCount));
 
-    String chalMsg = createMessageWithTTL("CHAL", selfId, peer->id, ttl, peer->messageCount, encryptedChallenge);
-    LoRa.beginPacket();
-    LoRa.print(chalMsg);
-    LoRa.endPacket();
+    String chalMsg = createMessageWithTTL("CHAL", selfId, peerId(peer), ttl, peer->messageCount, encryptedChallenge);
+    sendMessageWithTTL("CHAL", selfId, peerId(peer), ttl, peer->messageCount, encryptedChallenge);
 
-    Serial.println("🔐 Sending CHAL to " + peer->id);
+    Serial.println("🔐 Sending CHAL to " + peerId(peer));
     Serial.println("Challenge (plain): " + challengeStr);
-    Serial.println("Session Key: " + String(peer->sharedSessionKey));
+    Serial.println("Session Key: " + sessionKeyString(peer));
     Serial.println("Message Count: " + String(peer->messageCount));
     Serial.println("Encrypted CHAL: " + encryptedChallenge);
     Serial.println("CHAL Message Sent: " + chalMsg);
@@ -29,27 +30,31 @@ void handleAuthChallenge(NodeState *peer, const String &selfId, uint32_t ttl)
 
 bool verifyAuthResponse(NodeState *peer, const String &payload, uint32_t messageCount, const String &selfId)
 {
-    String decrypted = decryptString(payload, peer->sharedSessionKey, messageCount);
-    uint32_t expected = peer->challenge ^ peer->sharedSessionKey;
+    String decrypted;
+    if (!decryptFromPeer(peer, payload, messageCount,
+                         createAssociatedData("RESP", peerId(peer), selfId, messageCount), decrypted))
+    {
+        Serial.println("❌ RESP from " + peerId(peer) + " failed tag check. Ignoring.");
+        return false;
+    }
+
+    uint32_t expected = peer->challenge ^ authToken(peer);
 
-    Serial.println("📥 RESP Decrypted from " + peer->id + ": " + decrypted);
+    Serial.println("📥 RESP Decrypted from " + peerId(peer) + ": " + decrypted);
     Serial.println("Expected response: " + String(expected));
 
     if (decrypted.toInt() == expected)
     {
         peer->state = PeerState::AUTHENTICATED;
-        Serial.println("✅ Authentication successful with " + peer->id);
+        Serial.println("✅ Authentication successful with " + peerId(peer));
 
         // Notify peer that authentication succeeded
-        String successMsg = createMessage("AUTH_SUCCESS", selfId, peer->id, "OK");
-        LoRa.beginPacket();
-        LoRa.print(successMsg);
-        LoRa.endPacket();
+        sendMessage("AUTH_SUCCESS", selfId, peerId(peer), "OK");
         return true;
     }
     else
     {
-        Serial.println("❌ Authentication failed with " + peer->id);
+        Serial.println("❌ Authentication failed with " + peerId(peer));
         resetPeer(peer); // Reset peer state if response was wrong
         return false;
     }
@@ -57,27 +62,41 @@ bool verifyAuthResponse(NodeState *peer, const String &payload, uint32_t message
 
 void handleChallengeResponse(NodeState *peer, const LoRaMessage &msg, const String &selfId, uint32_t ttl)
 {
+    // A CHAL is only expected once the key exchange completed and before we are
+    // authenticated: a replayed CHAL must not make us encrypt another RESP
+    if (peer->state != PeerState::SECURE_COMM)
+    {
+        Serial.println("⚠️ CHAL from " + peerId(peer) + " outside the handshake. Ignoring.");
+        return;
+    }
+
     // Serial.println("📥 Raw LoRa Message: " + msg);
-    Serial.println("Session Key: " + String(peer->sharedSessionKey));
+    Serial.println("Session Key: " + sessionKeyString(peer));
     Serial.println("Message Count: " + String(msg.messageCount));
 
-    String decryptedChallenge = decryptString(msg.payload, peer->sharedSessionKey, msg.messageCount);
+    String decryptedChallenge;
+    if (!decryptFromPeer(peer, msg.payload, msg.messageCount,
+                         createAssociatedData(msg.type, msg.senderId, msg.receiverId, msg.messageCount), decryptedChallenge))
+    {
+        Serial.println("❌ CHAL from " + peerId(peer) + " failed tag check. Ignoring.");
+        return;
+    }
     Serial.println("📥 CHAL Decrypted: " + decryptedChallenge);
 
     // Compute response
-    uint32_t responseValue = decryptedChallenge.toInt() ^ peer->sharedSessionKey;
+    uint32_t responseValue = decryptedChallenge.toInt() ^ authToken(peer);
     String responseStr = String(responseValue);
 
-    // Advance message counter
-    peer->messageCount = msg.messageCount + 1;
+    // Continue above the challenger's counter, but never move ours backwards: a lower
+    // counter would reuse nonces already spent under this send key
+    if (peer->messageCount <= (uint32_t)msg.messageCount)
+        peer->messageCount = msg.messageCount + 1;
 
     // Encrypt and send response
-    String encryptedResponse = encryptString(responseStr, peer->sharedSessionKey, peer->messageCount);
-    String respMsg = createMessageWithTTL("RESP", selfId, peer->id, ttl, peer->messageCount, encryptedResponse);
-
-    LoRa.beginPacket();
-    LoRa.print(respMsg);
-    LoRa.endPacket();
+    String encryptedResponse = encryptForPeer(peer, responseStr, peer->messageCount,
+                                              createAssociatedData("RESP", selfId, peerId(peer), peer->messageCount));
+    sendMessageWithTTL("RESP", selfId, peerId(peer), ttl, peer->messageCount, encryptedResponse);
+    peer->messageCount++; // The first MSG must not reuse the RESP counter
 
-    Serial.println("🔐 Sent RESP to " + peer->id + ": " + responseStr);
+    Serial.println("🔐 Sent RESP to " + peerId(peer) + ": " + responseStr);
 }
@@ -5,6 +5,7 @@
 #include <LoRa.h>
 #include "NodeManager.h"
 #include "MessageUtils.h"
+#include "MessageTransport.h"
 #include "EncryptionUtils.h"
 
 /**
@@ -20,6 +21,10 @@ void handleAuthChallenge(NodeState *peer, const String &selfId, uint32_t ttl);
  */
 bool verifyAuthResponse(NodeState *peer, const String &payload, uint32_t messageCount, const String &selfId);
 
+/**
+ * Answers a peer's challenge with an encrypted RESP. Only accepted in SECURE_COMM; the
+ * message counter only ever moves forward.
+ */
 void handleChallengeResponse(NodeState *peer, const LoRaMessage &msg, const String &selfId, uint32_t ttl);
 
 #endif
@@ -0,0 +1,107 @@
+#include "FastHandshake.h"
+#include "MessageTransport.h"
+#include "EncryptionUtils.h"
+#include "ChaChaPoly.h"
+#include "PeerKeys.h"
+
+// Poly1305 tag over the transcript under the auth key, which never encrypts messages
+static String transcriptMac(const NodeState *peer, const String &initiatorId, const String &responderId,
+                            const String &initiatorKey, const String &responderKey)
+{
+    static const uint8_t nonce[CHACHA20_NONCE_SIZE] = {0, 0, 0, 0, 0, 0, 0, 0, 'K', 'X', 0, 0};
+    String transcript = "KX:" + initiatorId + ":" + responderId + ":" + initiatorKey + ":" + responderKey;
+
+    uint8_t tag[AEAD_TAG_SIZE];
+    aeadEncrypt(peer->authKey, nonce, (const uint8_t *)transcript.c_str(), transcript.length(),
+                nullptr, nullptr, 0, tag);
+    return base64Encode(tag, sizeof(tag));
+}
+
+// Constant-time comparison of two equal-length MAC strings
+static bool macEquals(const String &a, const String &b)
+{
+    if (a.length() != b.length())
+        return false;
+
+    uint8_t diff = 0;
+    for (size_t i = 0; i < a.length(); i++)
+        diff |= a[i] ^ b[i];
+    return diff == 0;
+}
+
+static void markHandshakeComplete(NodeState *peer)
+{
+    peer->pkSent = peer->pkReceived = peer->ackSent = peer->ackReceived = true;
+    peer->handshakeAttempts = 0;
+    peer->state = PeerState::AUTHENTICATED;
+}
+
+void startFastHandshake(NodeState *peer, const String &selfId, uint32_t seed)
+{
+    createLocalKeys(peer, seed);
+    sendMessage("KX_INIT", selfId, peerId(peer), publicKeyPayload(peer));
+
+    peer->state = PeerState::KX_SENT;
+    peer->handshakeSentAt = millis();
+    peer->handshakeAttempts++;
+
+    Serial.println("⚡ Sent KX_INIT to " + peerId(peer) + " (attempt " + String(peer->handshakeAttempts) + ")");
+}
+
+bool answerFastHandshake(NodeState *peer, const LoRaMessage &msg, const String &selfId, uint32_t seed)
+{
+    // A new initiator key means a new session; a repeat of the same key is a retry
+    if (!remotePublicKeyMatches(peer, msg.payload))
+        resetPeer(peer);
+
+    if (!storeRemotePublicKey(peer, msg.payload))
+    {
+        Serial.println("⚠️  Malformed KX_INIT from " + msg.senderId + ". Ignoring.");
+        return false;
+    }
+
+    createLocalKeys(peer, seed);
+    if (!deriveSessionKey(peer, selfId))
+    {
+        resetPeer(peer);
+        return false;
+    }
+
+    String ownKey = publicKeyPayload(peer);
+    String mac = transcriptMac(peer, msg.senderId, selfId, msg.payload, ownKey);
+    sendMessage("KX_CONFIRM", selfId, msg.senderId, ownKey + ":" + mac);
+
+    if (peer->state != PeerState::AUTHENTICATED)
+    {
+        peer->messageCount = 0;
+        markHandshakeComplete(peer);
+        Serial.println("⚡ 1-RTT handshake answered; " + peerId(peer) + " AUTHENTICATED");
+    }
+    return true;
+}
+
+bool completeFastHandshake(NodeState *peer, const LoRaMessage &msg, const String &selfId)
+{
+    if (peer->state != PeerState::KX_SENT)
+        return false;
+
+    int separator = msg.payload.lastIndexOf(':');
+    if (separator <= 0)
+        return false;
+
+    String remoteKey = msg.payload.substring(0, separator);
+    String mac = msg.payload.substring(separator + 1);
+
+    if (!storeRemotePublicKey(peer, remoteKey) || !deriveSessionKey(peer, selfId) ||
+        !macEquals(mac, transcriptMac(peer, selfId, msg.senderId, publicKeyPayload(peer), remoteKey)))
+    {
+        Serial.println("❌ KX_CONFIRM from " + msg.senderId + " failed key confirmation. Resetting.");
+        resetPeer(peer);
+        return false;
+    }
+
+    peer->messageCount = 0;
+    markHandshakeComplete(peer);
+    Serial.println("⚡ 1-RTT handshake complete; " + peerId(peer) + " AUTHENTICATED");
+    return true;
+}
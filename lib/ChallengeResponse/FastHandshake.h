@@ -0,0 +1,37 @@
+#ifndef FAST_HANDSHAKE_H
+#define FAST_HANDSHAKE_H
+
+#include <Arduino.h>
+#include "LoRaConfig.h"
+#include "NodeManager.h"
+#include "MessageUtils.h"
+
+// ========== 1-RTT handshake ==========
+// KX_INIT    initiator -> responder : <initiator public key>
+// KX_CONFIRM responder -> initiator : <responder public key>:<base64 MAC>
+// The MAC is a Poly1305 tag under the new session key over
+// "KX:<initiator>:<responder>:<initiator key>:<responder key>", so it confirms the key and binds
+// both identities and both public keys. The responder is AUTHENTICATED once it sends
+// KX_CONFIRM (only the initiator can read what it sends next); the initiator once the MAC verifies.
+
+#define FAST_HANDSHAKE_TIMEOUT 3000 // ms to wait for KX_CONFIRM before resending KX_INIT
+#define FAST_HANDSHAKE_ATTEMPTS 3   // KX_INITs before falling back to the PK/ACK/CHAL handshake
+
+/**
+ * Initiator: sends KX_INIT with our public key and moves the peer to KX_SENT.
+ */
+void startFastHandshake(NodeState *peer, const String &selfId, uint32_t seed);
+
+/**
+ * Responder: derives the session key from KX_INIT and answers with KX_CONFIRM.
+ * A repeated KX_INIT with the same key gets the same KX_CONFIRM again.
+ */
+bool answerFastHandshake(NodeState *peer, const LoRaMessage &msg, const String &selfId, uint32_t seed);
+
+/**
+ * Initiator: verifies KX_CONFIRM and marks the peer AUTHENTICATED.
+ * On a MAC mismatch the peer is reset.
+ */
+bool completeFastHandshake(NodeState *peer, const LoRaMessage &msg, const String &selfId);
+
+#endif
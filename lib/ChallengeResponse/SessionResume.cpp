@@ -0,0 +1,117 @@
+#include "SessionResume.h"
+#include "MessageTransport.h"
+#include "EncryptionUtils.h"
+#include "SessionTicket.h"
+#include "SecureRandom.h"
+#include "PeerKeys.h"
+
+static void sendResume(NodeState *peer, const String &selfId, uint32_t ttl)
+{
+    peer->challenge = secureRandomRange(100000, 999999);
+
+    String encrypted = encryptForPeer(peer, String(peer->challenge), peer->messageCount,
+                                      createAssociatedData("RESUME", selfId, peerId(peer), peer->messageCount));
+    sendMessageWithTTL("RESUME", selfId, peerId(peer), ttl, peer->messageCount, encrypted);
+
+    Serial.println("🎫 Sent RESUME to " + peerId(peer) + " (count " + String(peer->messageCount) + ")");
+
+    peer->messageCount++;
+    peer->resumeSentAt = millis();
+    peer->resumeAttempts++;
+}
+
+static void abandonSession(NodeState *peer, const String &selfId)
+{
+    eraseSessionTicket(peerId(peer));
+    resetPeer(peer);
+    sendMessage("CLEAR", selfId, peerId(peer), "RESET");
+}
+
+void startSessionResumption(const String &selfId, uint32_t ttl)
+{
+    for (auto &peer : peers)
+    {
+        if (peer.state == PeerState::RESUMING)
+            sendResume(&peer, selfId, ttl);
+    }
+}
+
+void handleResumeRequest(NodeState *peer, const LoRaMessage &msg, const String &selfId, uint32_t ttl, uint32_t seed)
+{
+    String challenge;
+    bool haveSession = peer->sharedSessionKey != 0 &&
+                       (peer->state == PeerState::AUTHENTICATED || peer->state == PeerState::RESUMING);
+
+    if (!haveSession ||
+        !decryptFromPeer(peer, msg.payload, msg.messageCount,
+                         createAssociatedData(msg.type, msg.senderId, msg.receiverId, msg.messageCount), challenge))
+    {
+        Serial.println("❌ Cannot resume session with " + msg.senderId + ". Requesting full handshake.");
+        abandonSession(peer, selfId);
+        return;
+    }
+
+    // Continue above every counter either side may have used before the reboot
+    if (peer->messageCount <= (uint32_t)msg.messageCount)
+        peer->messageCount = msg.messageCount + 1;
+
+    uint32_t response = challenge.toInt() ^ authToken(peer);
+    String encrypted = encryptForPeer(peer, String(response), peer->messageCount,
+                                      createAssociatedData("RESUMED", selfId, peerId(peer), peer->messageCount));
+    sendMessageWithTTL("RESUMED", selfId, peerId(peer), ttl, peer->messageCount, encrypted);
+    peer->messageCount++;
+
+    // Both ends hold tickets; our own RESUME (if any) is answered by this exchange as well
+    peer->state = PeerState::AUTHENTICATED;
+    peer->resumeAttempts = 0;
+    saveSessionTicket(peer, seed);
+
+    Serial.println("✅ Session with " + peerId(peer) + " resumed (peer request)");
+}
+
+bool verifyResumeResponse(NodeState *peer, const LoRaMessage &msg, const String &selfId, uint32_t seed)
+{
+    if (peer->state != PeerState::RESUMING)
+        return false;
+
+    String decrypted;
+    if (!decryptFromPeer(peer, msg.payload, msg.messageCount,
+                         createAssociatedData(msg.type, msg.senderId, msg.receiverId, msg.messageCount), decrypted) ||
+        (uint32_t)decrypted.toInt() != (peer->challenge ^ authToken(peer)))
+    {
+        Serial.println("❌ RESUMED from " + peerId(peer) + " did not verify. Falling back to full handshake.");
+        abandonSession(peer, selfId);
+        return false;
+    }
+
+    if (peer->messageCount <= (uint32_t)msg.messageCount)
+        peer->messageCount = msg.messageCount + 1;
+
+    peer->state = PeerState::AUTHENTICATED;
+    peer->resumeAttempts = 0;
+    saveSessionTicket(peer, seed);
+
+    Serial.println("✅ Session with " + peerId(peer) + " resumed in one round trip");
+    return true;
+}
+
+void checkResumeTimeouts(const String &selfId, uint32_t ttl)
+{
+    unsigned long now = millis();
+
+    for (auto &peer : peers)
+    {
+        if (peer.state != PeerState::RESUMING || now - peer.resumeSentAt < SESSION_RESUME_TIMEOUT)
+            continue;
+
+        if (peer.resumeAttempts < SESSION_RESUME_ATTEMPTS)
+        {
+            sendResume(&peer, selfId, ttl);
+        }
+        else
+        {
+            Serial.println("⌛ No RESUMED from " + peerId(&peer) + ". Falling back to full handshake.");
+            abandonSession(&peer, selfId);
+        }
+    }
+}
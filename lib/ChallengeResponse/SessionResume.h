@@ -0,0 +1,35 @@
+#ifndef SESSION_RESUME_H
+#define SESSION_RESUME_H
+
+#include <Arduino.h>
+#include "LoRaConfig.h"
+#include "NodeManager.h"
+#include "MessageUtils.h"
+
+#define SESSION_RESUME_TIMEOUT 4000 // ms to wait for RESUMED before retrying
+#define SESSION_RESUME_ATTEMPTS 3   // RESUME transmissions before falling back to a full handshake
+
+/**
+ * Sends RESUME to every peer restored from a session ticket.
+ * RESUME carries a fresh challenge encrypted under the stored session key.
+ */
+void startSessionResumption(const String &selfId, uint32_t ttl);
+
+/**
+ * Answers a peer's RESUME. If the challenge decrypts under our session key the peer is
+ * AUTHENTICATED again and gets RESUMED (challenge ^ key); otherwise our state is dropped and
+ * a CLEAR tells the peer to fall back to the full handshake.
+ */
+void handleResumeRequest(NodeState *peer, const LoRaMessage &msg, const String &selfId, uint32_t ttl, uint32_t seed);
+
+/**
+ * Verifies RESUMED and marks the peer AUTHENTICATED.
+ */
+bool verifyResumeResponse(NodeState *peer, const LoRaMessage &msg, const String &selfId, uint32_t seed);
+
+/**
+ * Retries unanswered RESUMEs and falls back (reset + ticket erase + CLEAR) after the last attempt.
+ */
+void checkResumeTimeouts(const String &selfId, uint32_t ttl);
+
+#endif
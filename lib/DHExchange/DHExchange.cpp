@@ -3,6 +3,7 @@
 // ===========================================
 
 #include "DHExchange.h"
+#include "SecureRandom.h"
 
 // Dummy prime and generator values are not used in this mock
 #define DH_PRIME 2147483647UL
@@ -17,10 +18,85 @@ uint32_t generatePrivateKey(uint32_t seed)
     return random(10000, 99999999); // Generates private key
 }
 
+// ========== Arithmetic mod DH_PRIME = 2^31 - 1 ==========
+// A Mersenne prime: x mod p = (x & p) + (x >> 31), folded twice, so no 64-bit division
+// (which the Cortex-M4 has to emulate in software) is needed.
+
+static inline uint32_t mulModMersenne31(uint32_t a, uint32_t b)
+{
+    uint64_t x = (uint64_t)a * b; // < 2^62
+    uint32_t r = (uint32_t)(x & DH_PRIME) + (uint32_t)(x >> 31);
+    r = (r & DH_PRIME) + (r >> 31);
+    return r >= DH_PRIME ? r - DH_PRIME : r;
+}
+
+static constexpr uint32_t mulModPrime(uint32_t a, uint32_t b)
+{
+    return (uint32_t)(((uint64_t)a * b) % DH_PRIME);
+}
+
+// Fixed-base table: generatorTable.powers[i][j] = 5^(j * 16^i) mod p, one row per 4-bit
+// window of the exponent. 512 bytes in flash; built by the compiler.
+struct GeneratorTable
+{
+    uint32_t powers[8][16];
+
+    constexpr GeneratorTable() : powers()
+    {
+        uint32_t windowBase = DH_GENERATOR; // 5^(16^i)
+        for (uint8_t i = 0; i < 8; i++)
+        {
+            powers[i][0] = 1;
+            for (uint8_t j = 1; j < 16; j++)
+                powers[i][j] = mulModPrime(powers[i][j - 1], windowBase);
+
+            uint32_t next = powers[i][15];
+            windowBase = mulModPrime(next, windowBase);
+        }
+    }
+};
+
+static constexpr GeneratorTable generatorTable;
+static_assert(generatorTable.powers[0][1] == DH_GENERATOR, "generator table row 0");
+static_assert(generatorTable.powers[1][1] == 116551688, "generator table row 1 (5^16 mod p)");
+
+// 5^exp mod p: one table lookup and at most 8 multiplications
+static uint32_t modexpGenerator(uint32_t exp)
+{
+    uint32_t result = generatorTable.powers[0][exp & 0x0F];
+    for (uint8_t i = 1; i < 8; i++)
+        result = mulModMersenne31(result, generatorTable.powers[i][(exp >> (4 * i)) & 0x0F]);
+    return result;
+}
+
+// base^exp mod p by square-and-multiply with Mersenne reduction
+static uint32_t modexpMersenne31(uint32_t base, uint32_t exp)
+{
+    uint32_t result = 1;
+    base = (base & DH_PRIME) + (base >> 31);
+    if (base >= DH_PRIME)
+        base -= DH_PRIME;
+
+    while (exp > 0)
+    {
+        if (exp & 1)
+            result = mulModMersenne31(result, base);
+
+        base = mulModMersenne31(base, base);
+        exp >>= 1;
+    }
+
+    return result;
+}
+
 // Perform modular exponentiation efficiently (base^exp) % mod
 // This is the core operation behind DH public/shared key generation
 uint32_t modexp(uint32_t base, uint32_t exp, uint32_t mod)
 {
+    if (mod == DH_PRIME)
+        return base == DH_GENERATOR ? modexpGenerator(exp) : modexpMersenne31(base, exp);
+
+    // Generic path for any other modulus
     uint64_t result = 1;
     uint64_t base64 = base;
 
@@ -51,3 +127,29 @@ uint32_t generateSharedKey(uint32_t remotePublicKey, uint32_t privateKey)
 {
     return modexp(remotePublicKey, privateKey, DH_PRIME);
 }
+
+void generatePrivateKey25519(uint32_t seed, uint8_t privateKey[X25519_KEY_SIZE])
+{
+    secureRandomAddEntropy(seed);
+    secureRandomBytes(privateKey, X25519_KEY_SIZE);
+
+    privateKey[0] &= 248;
+    privateKey[31] = (privateKey[31] & 127) | 64;
+}
+
+void generatePublicKey25519(const uint8_t privateKey[X25519_KEY_SIZE], uint8_t publicKey[X25519_KEY_SIZE])
+{
+    x25519Base(publicKey, privateKey);
+}
+
+bool generateSharedKey25519(const uint8_t remotePublicKey[X25519_KEY_SIZE], const uint8_t privateKey[X25519_KEY_SIZE],
+                            uint8_t sharedKey[X25519_KEY_SIZE])
+{
+    x25519(sharedKey, privateKey, remotePublicKey);
+
+    // Constant-time all-zero check (RFC 7748 section 6.1)
+    uint8_t acc = 0;
+    for (uint8_t i = 0; i < X25519_KEY_SIZE; i++)
+        acc |= sharedKey[i];
+    return acc != 0;
+}
@@ -7,6 +7,7 @@
 #define DH_EXCHANGE_H
 
 #include <Arduino.h>
+#include "X25519.h"
 
 /**
  * @brief Generates a  private key.
@@ -30,6 +31,9 @@ uint32_t generatePublicKey(uint32_t privateKey);
  * cryptographic algorithms like Diffie-Hellman where large exponents and moduli
  * are involved. It avoids integer overflow by working with 64-bit intermediate results.
  *
+ * For mod == 2^31 - 1 (the DH prime) reduction uses shifts instead of 64-bit division,
+ * and base 5 (the DH generator) uses a compile-time table of generator powers.
+ *
  * @param base The base number.
  * @param exp The exponent.
  * @param mod The modulus.
@@ -46,4 +50,30 @@ uint32_t modexp(uint32_t base, uint32_t exp, uint32_t mod);
  */
 uint32_t generateSharedKey(uint32_t remotePublicKey, uint32_t privateKey);
 
+// ========== X25519 (LORA_X25519) ==========
+
+/**
+ * @brief Generates a 32-byte X25519 private key.
+ *
+ * The EEPROM seed is mixed into the node random generator (SecureRandom.h), which is
+ * seeded from ADC noise and timer jitter, so the key is not recoverable from the 32-bit seed alone.
+ *
+ * @param seed The device seed from EEPROM
+ * @param privateKey Output: 32-byte private key (clamped)
+ */
+void generatePrivateKey25519(uint32_t seed, uint8_t privateKey[X25519_KEY_SIZE]);
+
+/**
+ * @brief Computes the 32-byte public key for an X25519 private key.
+ */
+void generatePublicKey25519(const uint8_t privateKey[X25519_KEY_SIZE], uint8_t publicKey[X25519_KEY_SIZE]);
+
+/**
+ * @brief Computes the 32-byte X25519 shared secret.
+ *
+ * @return false if the remote key is a low-order point (all-zero shared secret)
+ */
+bool generateSharedKey25519(const uint8_t remotePublicKey[X25519_KEY_SIZE], const uint8_t privateKey[X25519_KEY_SIZE],
+                            uint8_t sharedKey[X25519_KEY_SIZE]);
+
 #endif // DH_EXCHANGE_H
@@ -0,0 +1,177 @@
+// ===========================================
+// X25519.cpp
+// Field arithmetic follows the TweetNaCl layout: 16 signed limbs of 16 bits
+// ===========================================
+
+#include "X25519.h"
+
+typedef int64_t fe[16];
+
+static const fe fe121665 = {0xDB41, 1};
+
+static void carry(fe o)
+{
+    for (uint8_t i = 0; i < 16; i++)
+    {
+        o[i] += (1LL << 16);
+        int64_t c = o[i] >> 16;
+        o[(i + 1) * (i < 15)] += c - 1 + 37 * (c - 1) * (i == 15);
+        o[i] -= c << 16;
+    }
+}
+
+// Swaps p and q when b == 1, without branching on b
+static void conditionalSwap(fe p, fe q, int64_t b)
+{
+    int64_t mask = ~(b - 1);
+    for (uint8_t i = 0; i < 16; i++)
+    {
+        int64_t t = mask & (p[i] ^ q[i]);
+        p[i] ^= t;
+        q[i] ^= t;
+    }
+}
+
+static void pack(uint8_t *o, const fe n)
+{
+    fe m, t;
+    memcpy(t, n, sizeof(fe));
+    carry(t);
+    carry(t);
+    carry(t);
+
+    for (uint8_t j = 0; j < 2; j++)
+    {
+        m[0] = t[0] - 0xffed;
+        for (uint8_t i = 1; i < 15; i++)
+        {
+            m[i] = t[i] - 0xffff - ((m[i - 1] >> 16) & 1);
+            m[i - 1] &= 0xffff;
+        }
+        m[15] = t[15] - 0x7fff - ((m[14] >> 16) & 1);
+        int64_t b = (m[15] >> 16) & 1;
+        m[14] &= 0xffff;
+        conditionalSwap(t, m, 1 - b);
+    }
+
+    for (uint8_t i = 0; i < 16; i++)
+    {
+        o[2 * i] = t[i] & 0xff;
+        o[2 * i + 1] = t[i] >> 8;
+    }
+}
+
+static void unpack(fe o, const uint8_t *n)
+{
+    for (uint8_t i = 0; i < 16; i++)
+        o[i] = n[2 * i] + ((int64_t)n[2 * i + 1] << 8);
+    o[15] &= 0x7fff;
+}
+
+static void add(fe o, const fe a, const fe b)
+{
+    for (uint8_t i = 0; i < 16; i++)
+        o[i] = a[i] + b[i];
+}
+
+static void sub(fe o, const fe a, const fe b)
+{
+    for (uint8_t i = 0; i < 16; i++)
+        o[i] = a[i] - b[i];
+}
+
+static void mul(fe o, const fe a, const fe b)
+{
+    int64_t t[31] = {0};
+
+    for (uint8_t i = 0; i < 16; i++)
+        for (uint8_t j = 0; j < 16; j++)
+            t[i + j] += a[i] * b[j];
+
+    for (uint8_t i = 0; i < 15; i++)
+        t[i] += 38 * t[i + 16];
+
+    for (uint8_t i = 0; i < 16; i++)
+        o[i] = t[i];
+
+    carry(o);
+    carry(o);
+}
+
+static void square(fe o, const fe a)
+{
+    mul(o, a, a);
+}
+
+// o = i^(p-2) = i^-1 (mod p)
+static void invert(fe o, const fe i)
+{
+    fe c;
+    memcpy(c, i, sizeof(fe));
+
+    for (int a = 253; a >= 0; a--)
+    {
+        square(c, c);
+        if (a != 2 && a != 4)
+            mul(c, c, i);
+    }
+    memcpy(o, c, sizeof(fe));
+}
+
+void x25519(uint8_t out[X25519_KEY_SIZE], const uint8_t scalar[X25519_KEY_SIZE], const uint8_t point[X25519_KEY_SIZE])
+{
+    uint8_t z[32];
+    memcpy(z, scalar, 32);
+    z[31] = (z[31] & 127) | 64;
+    z[0] &= 248;
+
+    fe x, a, b, c, d, e, f;
+    unpack(x, point);
+
+    for (uint8_t i = 0; i < 16; i++)
+    {
+        b[i] = x[i];
+        d[i] = a[i] = c[i] = 0;
+    }
+    a[0] = d[0] = 1;
+
+    // Montgomery ladder: same sequence of field operations for every scalar bit
+    for (int i = 254; i >= 0; --i)
+    {
+        int64_t r = (z[i >> 3] >> (i & 7)) & 1;
+        conditionalSwap(a, b, r);
+        conditionalSwap(c, d, r);
+        add(e, a, c);
+        sub(a, a, c);
+        add(c, b, d);
+        sub(b, b, d);
+        square(d, e);
+        square(f, a);
+        mul(a, c, a);
+        mul(c, b, e);
+        add(e, a, c);
+        sub(a, a, c);
+        square(b, a);
+        sub(c, d, f);
+        mul(a, c, fe121665);
+        add(a, a, d);
+        mul(c, c, a);
+        mul(a, d, f);
+        mul(d, b, x);
+        square(b, e);
+        conditionalSwap(a, b, r);
+        conditionalSwap(c, d, r);
+    }
+
+    invert(c, c);
+    mul(a, a, c);
+    pack(out, a);
+
+    memset(z, 0, sizeof(z));
+}
+
+void x25519Base(uint8_t out[X25519_KEY_SIZE], const uint8_t scalar[X25519_KEY_SIZE])
+{
+    static const uint8_t basePoint[X25519_KEY_SIZE] = {9};
+    x25519(out, scalar, basePoint);
+}
@@ -0,0 +1,26 @@
+// ===========================================
+// X25519.h
+// Curve25519 Diffie-Hellman (RFC 7748)
+// ===========================================
+
+#ifndef X25519_H
+#define X25519_H
+
+#include <Arduino.h>
+
+#define X25519_KEY_SIZE 32
+
+/**
+ * @brief Computes out = scalar * point on Curve25519 (u-coordinate only).
+ *
+ * Constant-time Montgomery ladder over 16 x 16-bit limbs; uses only the stack.
+ * The scalar is clamped internally as required by RFC 7748.
+ */
+void x25519(uint8_t out[X25519_KEY_SIZE], const uint8_t scalar[X25519_KEY_SIZE], const uint8_t point[X25519_KEY_SIZE]);
+
+/**
+ * @brief Computes the public key for a private key (scalar * base point 9).
+ */
+void x25519Base(uint8_t out[X25519_KEY_SIZE], const uint8_t scalar[X25519_KEY_SIZE]);
+
+#endif // X25519_H
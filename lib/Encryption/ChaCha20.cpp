@@ -0,0 +1,74 @@
+#include "ChaCha20.h"
+
+#define ROTL32(v, n) (((v) << (n)) | ((v) >> (32 - (n))))
+
+#define QUARTER_ROUND(a, b, c, d) \
+    a += b;                       \
+    d = ROTL32(d ^ a, 16);        \
+    c += d;                       \
+    b = ROTL32(b ^ c, 12);        \
+    a += b;                       \
+    d = ROTL32(d ^ a, 8);         \
+    c += d;                       \
+    b = ROTL32(b ^ c, 7)
+
+static inline uint32_t load32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+void chacha20Block(const uint8_t key[CHACHA20_KEY_SIZE], const uint8_t nonce[CHACHA20_NONCE_SIZE],
+                   uint32_t counter, uint32_t block[16])
+{
+    uint32_t state[16] = {
+        0x61707865, 0x3320646e, 0x79622d32, 0x6b206574, // "expand 32-byte k"
+        load32(key), load32(key + 4), load32(key + 8), load32(key + 12),
+        load32(key + 16), load32(key + 20), load32(key + 24), load32(key + 28),
+        counter, load32(nonce), load32(nonce + 4), load32(nonce + 8)};
+
+    uint32_t x[16];
+    memcpy(x, state, sizeof(x));
+
+    for (uint8_t i = 0; i < 10; i++)
+    {
+        QUARTER_ROUND(x[0], x[4], x[8], x[12]);
+        QUARTER_ROUND(x[1], x[5], x[9], x[13]);
+        QUARTER_ROUND(x[2], x[6], x[10], x[14]);
+        QUARTER_ROUND(x[3], x[7], x[11], x[15]);
+        QUARTER_ROUND(x[0], x[5], x[10], x[15]);
+        QUARTER_ROUND(x[1], x[6], x[11], x[12]);
+        QUARTER_ROUND(x[2], x[7], x[8], x[13]);
+        QUARTER_ROUND(x[3], x[4], x[9], x[14]);
+    }
+
+    for (uint8_t i = 0; i < 16; i++)
+        block[i] = x[i] + state[i];
+}
+
+void chacha20Xor(const uint8_t key[CHACHA20_KEY_SIZE], const uint8_t nonce[CHACHA20_NONCE_SIZE],
+                 uint32_t counter, const uint8_t *input, uint8_t *output, size_t length)
+{
+    uint32_t block[16];
+
+    while (length > 0)
+    {
+        chacha20Block(key, nonce, counter++, block);
+        size_t n = length < CHACHA20_BLOCK_SIZE ? length : CHACHA20_BLOCK_SIZE;
+        size_t i = 0;
+
+        // Word-wide XOR (Cortex-M4 and the host are little-endian, matching the block layout)
+        for (; i + 4 <= n; i += 4)
+        {
+            uint32_t word;
+            memcpy(&word, input + i, 4);
+            word ^= block[i / 4];
+            memcpy(output + i, &word, 4);
+        }
+        for (; i < n; i++)
+            output[i] = input[i] ^ (uint8_t)(block[i / 4] >> (8 * (i % 4)));
+
+        input += n;
+        output += n;
+        length -= n;
+    }
+}
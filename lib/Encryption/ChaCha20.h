@@ -0,0 +1,23 @@
+#ifndef CHACHA20_H
+#define CHACHA20_H
+
+#include <Arduino.h>
+
+#define CHACHA20_KEY_SIZE 32
+#define CHACHA20_NONCE_SIZE 12
+#define CHACHA20_BLOCK_SIZE 64
+
+/**
+ * Computes one 64-byte ChaCha20 keystream block (RFC 8439) as 16 little-endian words.
+ */
+void chacha20Block(const uint8_t key[CHACHA20_KEY_SIZE], const uint8_t nonce[CHACHA20_NONCE_SIZE],
+                   uint32_t counter, uint32_t block[16]);
+
+/**
+ * XORs `length` bytes of `input` with the ChaCha20 keystream starting at block `counter`.
+ * `input` and `output` may be the same buffer. Uses no heap and no global state.
+ */
+void chacha20Xor(const uint8_t key[CHACHA20_KEY_SIZE], const uint8_t nonce[CHACHA20_NONCE_SIZE],
+                 uint32_t counter, const uint8_t *input, uint8_t *output, size_t length);
+
+#endif
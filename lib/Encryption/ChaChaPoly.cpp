@@ -0,0 +1,110 @@
+#include "ChaChaPoly.h"
+
+static const uint8_t zeroPad[16] = {0};
+
+// Poly1305 over AD || pad || ciphertext || pad || len(AD) || len(ciphertext)
+static void computeTagWithKey(const uint8_t polyKey[POLY1305_KEY_SIZE],
+                              const uint8_t *associatedData, size_t associatedLength,
+                              const uint8_t *cipherText, size_t length, uint8_t tag[AEAD_TAG_SIZE])
+{
+    Poly1305 mac;
+    poly1305Init(mac, polyKey);
+    poly1305Update(mac, associatedData, associatedLength);
+    poly1305Update(mac, zeroPad, (16 - associatedLength % 16) % 16);
+    poly1305Update(mac, cipherText, length);
+    poly1305Update(mac, zeroPad, (16 - length % 16) % 16);
+
+    uint8_t lengths[16];
+    uint64_t a = associatedLength, c = length;
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        lengths[i] = (a >> (8 * i)) & 0xFF;
+        lengths[8 + i] = (c >> (8 * i)) & 0xFF;
+    }
+    poly1305Update(mac, lengths, sizeof(lengths));
+    poly1305Finish(mac, tag);
+}
+
+static void computeTag(const uint8_t key[CHACHA20_KEY_SIZE], const uint8_t nonce[CHACHA20_NONCE_SIZE],
+                       const uint8_t *associatedData, size_t associatedLength,
+                       const uint8_t *cipherText, size_t length, uint8_t tag[AEAD_TAG_SIZE])
+{
+    uint8_t polyKey[POLY1305_KEY_SIZE];
+    aeadPolyKey(key, nonce, polyKey);
+    computeTagWithKey(polyKey, associatedData, associatedLength, cipherText, length, tag);
+    memset(polyKey, 0, sizeof(polyKey));
+}
+
+static bool tagEquals(const uint8_t expected[AEAD_TAG_SIZE], const uint8_t tag[AEAD_TAG_SIZE])
+{
+    uint8_t diff = 0;
+    for (uint8_t i = 0; i < AEAD_TAG_SIZE; i++)
+        diff |= expected[i] ^ tag[i];
+    return diff == 0;
+}
+
+static void xorBytes(const uint8_t *input, const uint8_t *keystream, uint8_t *output, size_t length)
+{
+    for (size_t i = 0; i < length; i++)
+        output[i] = input[i] ^ keystream[i];
+}
+
+void aeadPolyKey(const uint8_t key[CHACHA20_KEY_SIZE], const uint8_t nonce[CHACHA20_NONCE_SIZE],
+                 uint8_t polyKey[POLY1305_KEY_SIZE])
+{
+    uint32_t block[16];
+    chacha20Block(key, nonce, 0, block);
+
+    for (uint8_t i = 0; i < POLY1305_KEY_SIZE; i++)
+        polyKey[i] = (uint8_t)(block[i / 4] >> (8 * (i % 4)));
+
+    memset(block, 0, sizeof(block));
+}
+
+void aeadEncrypt(const uint8_t key[CHACHA20_KEY_SIZE], const uint8_t nonce[CHACHA20_NONCE_SIZE],
+                 const uint8_t *associatedData, size_t associatedLength,
+                 const uint8_t *plainText, uint8_t *cipherText, size_t length,
+                 uint8_t tag[AEAD_TAG_SIZE])
+{
+    chacha20Xor(key, nonce, 1, plainText, cipherText, length);
+    computeTag(key, nonce, associatedData, associatedLength, cipherText, length, tag);
+}
+
+bool aeadDecrypt(const uint8_t key[CHACHA20_KEY_SIZE], const uint8_t nonce[CHACHA20_NONCE_SIZE],
+                 const uint8_t *associatedData, size_t associatedLength,
+                 const uint8_t *cipherText, uint8_t *plainText, size_t length,
+                 const uint8_t tag[AEAD_TAG_SIZE])
+{
+    uint8_t expected[AEAD_TAG_SIZE];
+    computeTag(key, nonce, associatedData, associatedLength, cipherText, length, expected);
+
+    if (!tagEquals(expected, tag))
+        return false;
+
+    chacha20Xor(key, nonce, 1, cipherText, plainText, length);
+    return true;
+}
+
+void aeadEncryptPrecomputed(const uint8_t polyKey[POLY1305_KEY_SIZE], const uint8_t *keystream,
+                            const uint8_t *associatedData, size_t associatedLength,
+                            const uint8_t *plainText, uint8_t *cipherText, size_t length,
+                            uint8_t tag[AEAD_TAG_SIZE])
+{
+    xorBytes(plainText, keystream, cipherText, length);
+    computeTagWithKey(polyKey, associatedData, associatedLength, cipherText, length, tag);
+}
+
+bool aeadDecryptPrecomputed(const uint8_t polyKey[POLY1305_KEY_SIZE], const uint8_t *keystream,
+                            const uint8_t *associatedData, size_t associatedLength,
+                            const uint8_t *cipherText, uint8_t *plainText, size_t length,
+                            const uint8_t tag[AEAD_TAG_SIZE])
+{
+    uint8_t expected[AEAD_TAG_SIZE];
+    computeTagWithKey(polyKey, associatedData, associatedLength, cipherText, length, expected);
+
+    if (!tagEquals(expected, tag))
+        return false;
+
+    xorBytes(cipherText, keystream, plainText, length);
+    return true;
+}
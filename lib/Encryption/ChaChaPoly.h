@@ -0,0 +1,50 @@
+#ifndef CHACHA_POLY_H
+#define CHACHA_POLY_H
+
+#include <Arduino.h>
+#include "ChaCha20.h"
+#include "Poly1305.h"
+
+#define AEAD_TAG_SIZE POLY1305_TAG_SIZE
+
+/**
+ * ChaCha20-Poly1305 AEAD (RFC 8439) encryption.
+ * Encrypts `length` bytes and writes a 16-byte tag over the associated data and ciphertext.
+ */
+void aeadEncrypt(const uint8_t key[CHACHA20_KEY_SIZE], const uint8_t nonce[CHACHA20_NONCE_SIZE],
+                 const uint8_t *associatedData, size_t associatedLength,
+                 const uint8_t *plainText, uint8_t *cipherText, size_t length,
+                 uint8_t tag[AEAD_TAG_SIZE]);
+
+/**
+ * ChaCha20-Poly1305 AEAD decryption.
+ * The tag is verified (in constant time) before any plaintext is produced;
+ * returns false and leaves `plainText` untouched if it does not match.
+ */
+bool aeadDecrypt(const uint8_t key[CHACHA20_KEY_SIZE], const uint8_t nonce[CHACHA20_NONCE_SIZE],
+                 const uint8_t *associatedData, size_t associatedLength,
+                 const uint8_t *cipherText, uint8_t *plainText, size_t length,
+                 const uint8_t tag[AEAD_TAG_SIZE]);
+
+/**
+ * The one-time Poly1305 key for (key, nonce): the first 32 bytes of ChaCha20 block 0.
+ */
+void aeadPolyKey(const uint8_t key[CHACHA20_KEY_SIZE], const uint8_t nonce[CHACHA20_NONCE_SIZE],
+                 uint8_t polyKey[POLY1305_KEY_SIZE]);
+
+/**
+ * aeadEncrypt/aeadDecrypt with the ChaCha20 work done in advance (KeystreamCache.h):
+ * `polyKey` from aeadPolyKey and `keystream` = ChaCha20 blocks 1.. for the same key and
+ * nonce, at least `length` bytes. Output is identical to the non-precomputed calls.
+ */
+void aeadEncryptPrecomputed(const uint8_t polyKey[POLY1305_KEY_SIZE], const uint8_t *keystream,
+                            const uint8_t *associatedData, size_t associatedLength,
+                            const uint8_t *plainText, uint8_t *cipherText, size_t length,
+                            uint8_t tag[AEAD_TAG_SIZE]);
+
+bool aeadDecryptPrecomputed(const uint8_t polyKey[POLY1305_KEY_SIZE], const uint8_t *keystream,
+                            const uint8_t *associatedData, size_t associatedLength,
+                            const uint8_t *cipherText, uint8_t *plainText, size_t length,
+                            const uint8_t tag[AEAD_TAG_SIZE]);
+
+#endif
@@ -1,9 +1,13 @@
 #include "EncryptionUtils.h"
 #include "base64.hpp"
+#include "ChaCha20.h"
+#include "ChaChaPoly.h"
+#include "LoRaConfig.h"
+#include "KeystreamCache.h"
 
 String base64Encode(uint8_t *data, size_t length)
 {
-    char encoded[256]; // adjust size as needed
+    char encoded[345]; // fits the base64 of a full 255-byte LoRa packet
     encode_base64(data, length, (uint8_t *)encoded);
     return String(encoded);
 }
@@ -14,17 +18,37 @@ bool base64Decode(String input, uint8_t *output, size_t *decodedLength)
     return *decodedLength > 0;
 }
 
-// XOR-based stream cipher with seeded PRNG
+// XOR-based stream cipher: ChaCha20 keyed by the session key, nonce = message counter.
+// Self-contained, so it no longer reseeds the Arduino PRNG used elsewhere.
+void expandSessionKey(uint32_t sessionKey, uint8_t key[SESSION_KEY_SIZE])
+{
+    memset(key, 0, SESSION_KEY_SIZE);
+    for (uint8_t i = 0; i < 4; i++)
+        key[i] = (sessionKey >> (8 * i)) & 0xFF;
+}
+
+static void messageNonce(uint32_t messageCount, uint8_t nonce[CHACHA20_NONCE_SIZE])
+{
+    memset(nonce, 0, CHACHA20_NONCE_SIZE);
+    for (uint8_t i = 0; i < 4; i++)
+        nonce[i] = (messageCount >> (8 * i)) & 0xFF;
+}
+
+static void keyedStreamCipher(const uint8_t *input, uint8_t *output, size_t length,
+                              const uint8_t key[SESSION_KEY_SIZE], uint32_t messageCount)
+{
+    uint8_t nonce[CHACHA20_NONCE_SIZE];
+    messageNonce(messageCount, nonce);
+
+    chacha20Xor(key, nonce, 0, input, output, length);
+}
+
 void streamCipherBytes(uint8_t *input, uint8_t *output, size_t length, uint32_t sessionKey, uint32_t messageCount)
 {
-    uint32_t seed = sessionKey + messageCount;
-    randomSeed(seed);
+    uint8_t key[CHACHA20_KEY_SIZE];
+    expandSessionKey(sessionKey, key);
 
-    for (size_t i = 0; i < length; i++)
-    {
-        uint8_t keystreamByte = random(0, 256);
-        output[i] = input[i] ^ keystreamByte;
-    }
+    keyedStreamCipher(input, output, length, key, messageCount);
 }
 
 // Encrypts a string using XOR stream cipher
@@ -58,3 +82,144 @@ String decryptString(const String &encryptedText, uint32_t sessionKey, uint32_t
 
     return result;
 }
+
+bool precomputeKeystream(const uint8_t sessionKey[SESSION_KEY_SIZE], uint32_t messageCount)
+{
+    if (isKeystreamCached(sessionKey, messageCount))
+        return false;
+
+    KeystreamEntry *entry = reserveKeystreamSlot(sessionKey);
+    if (!entry)
+        return false;
+
+    uint8_t nonce[CHACHA20_NONCE_SIZE];
+    messageNonce(messageCount, nonce);
+
+    uint32_t block[16];
+#if LORA_AEAD
+    aeadPolyKey(sessionKey, nonce, entry->polyKey);
+    chacha20Block(sessionKey, nonce, 1, block);
+#else
+    chacha20Block(sessionKey, nonce, 0, block);
+#endif
+    memcpy(entry->stream, block, KEYSTREAM_CACHE_BYTES);
+    memcpy(entry->key, sessionKey, SESSION_KEY_SIZE);
+    entry->messageCount = messageCount;
+    entry->valid = true;
+
+    memset(block, 0, sizeof(block));
+    countPrecomputedKeystream();
+    return true;
+}
+
+#if LORA_AEAD
+
+// ChaCha20-Poly1305: base64(ciphertext || tag)
+String encryptPayload(const String &plainText, const uint8_t sessionKey[SESSION_KEY_SIZE], uint32_t messageCount, const String &associatedData)
+{
+    size_t length = plainText.length();
+    uint8_t sealed[length + AEAD_TAG_SIZE];
+    KeystreamEntry *cached = takeKeystream(sessionKey, messageCount, length);
+    if (cached)
+    {
+        aeadEncryptPrecomputed(cached->polyKey, cached->stream, (const uint8_t *)associatedData.c_str(),
+                               associatedData.length(), (const uint8_t *)plainText.c_str(), sealed, length, sealed + length);
+        releaseKeystream(cached);
+    }
+    else
+    {
+        uint8_t nonce[CHACHA20_NONCE_SIZE];
+        messageNonce(messageCount, nonce);
+        aeadEncrypt(sessionKey, nonce, (const uint8_t *)associatedData.c_str(), associatedData.length(),
+                    (const uint8_t *)plainText.c_str(), sealed, length, sealed + length);
+    }
+
+    return base64Encode(sealed, length + AEAD_TAG_SIZE);
+}
+
+bool decryptPayload(const String &encryptedText, const uint8_t sessionKey[SESSION_KEY_SIZE], uint32_t messageCount,
+                    const String &associatedData, String &plainText)
+{
+    size_t length = 0;
+    uint8_t decoded[128 + AEAD_TAG_SIZE], decrypted[128];
+
+    if (encryptedText.length() > (sizeof(decoded) / 3) * 4 || !base64Decode(encryptedText, decoded, &length))
+        return false;
+    if (length < AEAD_TAG_SIZE)
+        return false;
+
+    length -= AEAD_TAG_SIZE;
+    KeystreamEntry *cached = takeKeystream(sessionKey, messageCount, length);
+    if (cached)
+    {
+        // A forged frame leaves the entry in place for the genuine one
+        if (!aeadDecryptPrecomputed(cached->polyKey, cached->stream, (const uint8_t *)associatedData.c_str(),
+                                    associatedData.length(), decoded, decrypted, length, decoded + length))
+            return false;
+        releaseKeystream(cached);
+    }
+    else
+    {
+        uint8_t nonce[CHACHA20_NONCE_SIZE];
+        messageNonce(messageCount, nonce);
+        if (!aeadDecrypt(sessionKey, nonce, (const uint8_t *)associatedData.c_str(), associatedData.length(),
+                         decoded, decrypted, length, decoded + length))
+            return false;
+    }
+
+    plainText = "";
+    for (size_t i = 0; i < length; i++)
+        plainText += (char)decrypted[i];
+    return true;
+}
+
+#else
+
+// Unauthenticated ChaCha20: base64(ciphertext)
+String encryptPayload(const String &plainText, const uint8_t sessionKey[SESSION_KEY_SIZE], uint32_t messageCount, const String &associatedData)
+{
+    size_t length = plainText.length();
+    uint8_t encrypted[length];
+
+    KeystreamEntry *cached = takeKeystream(sessionKey, messageCount, length);
+    if (cached)
+    {
+        for (size_t i = 0; i < length; i++)
+            encrypted[i] = (uint8_t)plainText[i] ^ cached->stream[i];
+        releaseKeystream(cached);
+    }
+    else
+    {
+        keyedStreamCipher((const uint8_t *)plainText.c_str(), encrypted, length, sessionKey, messageCount);
+    }
+    return base64Encode(encrypted, length);
+}
+
+bool decryptPayload(const String &encryptedText, const uint8_t sessionKey[SESSION_KEY_SIZE], uint32_t messageCount,
+                    const String &associatedData, String &plainText)
+{
+    size_t length = 0;
+    uint8_t decoded[128];
+
+    if (encryptedText.length() > (sizeof(decoded) / 3) * 4 || !base64Decode(encryptedText, decoded, &length))
+        return false;
+
+    KeystreamEntry *cached = takeKeystream(sessionKey, messageCount, length);
+    if (cached)
+    {
+        for (size_t i = 0; i < length; i++)
+            decoded[i] ^= cached->stream[i];
+        releaseKeystream(cached);
+    }
+    else
+    {
+        keyedStreamCipher(decoded, decoded, length, sessionKey, messageCount);
+    }
+
+    plainText = "";
+    for (size_t i = 0; i < length; i++)
+        plainText += (char)decoded[i];
+    return true;
+}
+
+#endif
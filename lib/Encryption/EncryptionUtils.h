@@ -3,13 +3,36 @@
 
 #include <Arduino.h>
 
-// Encrypts a byte array using a stream cipher with sessionKey and messageCount
+#define SESSION_KEY_SIZE 32 // Symmetric key for CHAL/RESP/MSG payloads (ChaCha20 key)
+
+// Base64 helpers used to carry ciphertext inside ASCII frames
+String base64Encode(uint8_t *data, size_t length);
+bool base64Decode(String input, uint8_t *output, size_t *decodedLength);
+
+// Encrypts a byte array with the ChaCha20 keystream for sessionKey and messageCount
 void streamCipherBytes(uint8_t *input, uint8_t *output, size_t length, uint32_t sessionKey, uint32_t messageCount);
 
+// Widens a 32-bit session key (legacy DH) into a ChaCha20 key: little-endian bytes 0..3, rest zero
+void expandSessionKey(uint32_t sessionKey, uint8_t key[SESSION_KEY_SIZE]);
+
 // Encrypts a plain text string (output is gibberish but reversible)
 String encryptString(const String &plainText, uint32_t sessionKey, uint32_t messageCount);
 
 // Decrypts a stream-ciphered string back into plain text
 String decryptString(const String &encryptedText, uint32_t sessionKey, uint32_t messageCount);
 
+// Encrypts a CHAL/RESP/MSG payload under the peer's 32-byte session key, nonce = messageCount. With LORA_AEAD the base64 output carries
+// ciphertext + 16-byte tag bound to `associatedData` (see createAssociatedData).
+String encryptPayload(const String &plainText, const uint8_t sessionKey[SESSION_KEY_SIZE], uint32_t messageCount, const String &associatedData);
+
+// Decrypts a payload from encryptPayload. With LORA_AEAD the tag is checked first and
+// false is returned, without producing any plaintext, if the frame was corrupted or forged.
+bool decryptPayload(const String &encryptedText, const uint8_t sessionKey[SESSION_KEY_SIZE], uint32_t messageCount,
+                    const String &associatedData, String &plainText);
+
+// Idle-time work: computes the keystream for (sessionKey, messageCount) into the keystream cache
+// (KeystreamCache.h), which encryptPayload/decryptPayload use for that counter. Returns false
+// if it was already cached or the cache is disabled.
+bool precomputeKeystream(const uint8_t sessionKey[SESSION_KEY_SIZE], uint32_t messageCount);
+
 #endif
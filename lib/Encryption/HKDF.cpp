@@ -0,0 +1,41 @@
+#include "HKDF.h"
+
+void hkdfExtract(const uint8_t *salt, size_t saltLength, const uint8_t *inputKey, size_t inputLength,
+                 uint8_t prk[SHA256_DIGEST_SIZE])
+{
+    static const uint8_t zeroSalt[SHA256_DIGEST_SIZE] = {0};
+    if (!salt)
+    {
+        salt = zeroSalt;
+        saltLength = sizeof(zeroSalt);
+    }
+
+    hmacSha256(salt, saltLength, inputKey, inputLength, prk);
+}
+
+void hkdfExpand(const uint8_t prk[SHA256_DIGEST_SIZE], const uint8_t *info, size_t infoLength,
+                uint8_t *output, size_t length)
+{
+    // T(i) = HMAC(prk, T(i-1) || info || i), T(0) empty
+    uint8_t block[SHA256_DIGEST_SIZE];
+    uint8_t counter = 1;
+
+    while (length > 0)
+    {
+        HmacSha256 ctx;
+        hmacSha256Init(ctx, prk, SHA256_DIGEST_SIZE);
+        if (counter > 1)
+            hmacSha256Update(ctx, block, SHA256_DIGEST_SIZE);
+        hmacSha256Update(ctx, info, infoLength);
+        hmacSha256Update(ctx, &counter, 1);
+        hmacSha256Finish(ctx, block);
+        counter++;
+
+        size_t take = length < SHA256_DIGEST_SIZE ? length : SHA256_DIGEST_SIZE;
+        memcpy(output, block, take);
+        output += take;
+        length -= take;
+    }
+
+    memset(block, 0, sizeof(block));
+}
@@ -0,0 +1,20 @@
+#ifndef HKDF_H
+#define HKDF_H
+
+#include <Arduino.h>
+#include "SHA256.h"
+
+/**
+ * HKDF-Extract (RFC 5869) with HMAC-SHA256: prk = HMAC(salt, ikm).
+ * A null salt means HashLen zero bytes.
+ */
+void hkdfExtract(const uint8_t *salt, size_t saltLength, const uint8_t *inputKey, size_t inputLength,
+                 uint8_t prk[SHA256_DIGEST_SIZE]);
+
+/**
+ * HKDF-Expand (RFC 5869) with HMAC-SHA256. `length` may be at most 255 * 32 bytes.
+ */
+void hkdfExpand(const uint8_t prk[SHA256_DIGEST_SIZE], const uint8_t *info, size_t infoLength,
+                uint8_t *output, size_t length);
+
+#endif
@@ -0,0 +1,35 @@
+#include "KeySchedule.h"
+#include "HKDF.h"
+
+static void expandLabel(const uint8_t prk[SHA256_DIGEST_SIZE], const String &label, uint8_t key[SESSION_KEY_SIZE])
+{
+    hkdfExpand(prk, (const uint8_t *)label.c_str(), label.length(), key, SESSION_KEY_SIZE);
+}
+
+void deriveTrafficKeys(const uint8_t *secret, size_t secretLength, const String &localId, const String &remoteId,
+                       uint8_t sendKey[SESSION_KEY_SIZE], uint8_t receiveKey[SESSION_KEY_SIZE],
+                       uint8_t authKey[SESSION_KEY_SIZE])
+{
+    static const char salt[] = "lora-p2p key schedule v1";
+    uint8_t prk[SHA256_DIGEST_SIZE];
+    hkdfExtract((const uint8_t *)salt, sizeof(salt) - 1, secret, secretLength, prk);
+
+    expandLabel(prk, "key " + localId + ">" + remoteId, sendKey);
+    expandLabel(prk, "key " + remoteId + ">" + localId, receiveKey);
+
+    // Same label on both ends: order the IDs instead of using local/remote
+    bool localFirst = strcmp(localId.c_str(), remoteId.c_str()) < 0;
+    expandLabel(prk, "auth " + (localFirst ? localId : remoteId) + "|" + (localFirst ? remoteId : localId), authKey);
+
+    memset(prk, 0, sizeof(prk));
+}
+
+void ratchetKey(uint8_t key[SESSION_KEY_SIZE])
+{
+    static const uint8_t label[] = {'r', 'a', 't', 'c', 'h', 'e', 't'};
+    uint8_t next[SESSION_KEY_SIZE];
+    hkdfExpand(key, label, sizeof(label), next, SESSION_KEY_SIZE);
+
+    memcpy(key, next, SESSION_KEY_SIZE);
+    memset(next, 0, sizeof(next));
+}
@@ -0,0 +1,39 @@
+#ifndef KEY_SCHEDULE_H
+#define KEY_SCHEDULE_H
+
+#include <Arduino.h>
+#include "LoRaConfig.h"
+#include "EncryptionUtils.h"
+
+// ========== Per-peer key schedule ==========
+// The DH secret is never used as a cipher key. HKDF-SHA256 turns it into three keys:
+//   send    = HKDF(secret, "key " + local + ">" + remote)   encrypts what we send
+//   receive = HKDF(secret, "key " + remote + ">" + local)   decrypts what the peer sends
+//   auth    = HKDF(secret, "auth " + lowId + "|" + highId)  challenge and transcript proofs
+// so the two directions never share a (key, counter) nonce. Each direction is a one-way
+// chain: the key for epoch e + 1 is HKDF-Expand(key_e, "ratchet"), and the epoch of a frame
+// is its counter / LORA_REKEY_FRAMES, so both ends step the chain without extra frames.
+
+/**
+ * Derives the send, receive and auth keys from a DH shared secret.
+ * Both ends pass their own ID as `localId`, so one end's send key is the other's receive key.
+ */
+void deriveTrafficKeys(const uint8_t *secret, size_t secretLength, const String &localId, const String &remoteId,
+                       uint8_t sendKey[SESSION_KEY_SIZE], uint8_t receiveKey[SESSION_KEY_SIZE],
+                       uint8_t authKey[SESSION_KEY_SIZE]);
+
+/**
+ * Replaces a traffic key with the key for the next epoch. The old key cannot be
+ * recomputed from the new one.
+ */
+void ratchetKey(uint8_t key[SESSION_KEY_SIZE]);
+
+/**
+ * Key epoch that protects a frame with this counter.
+ */
+inline uint32_t keyEpoch(uint32_t messageCount)
+{
+    return messageCount / LORA_REKEY_FRAMES;
+}
+
+#endif
@@ -0,0 +1,123 @@
+#include "KeystreamCache.h"
+
+static KeystreamCacheStats stats = {0, 0, 0, 0};
+
+#if LORA_KEYSTREAM_CACHE_PEERS > 0
+
+static KeystreamEntry entries[KEYSTREAM_CACHE_SLOTS];
+static uint8_t nextVictim = 0;
+
+static bool sameKey(const KeystreamEntry &entry, const uint8_t key[SESSION_KEY_SIZE])
+{
+    return memcmp(entry.key, key, SESSION_KEY_SIZE) == 0;
+}
+
+static KeystreamEntry *findEntry(const uint8_t key[SESSION_KEY_SIZE], uint32_t messageCount)
+{
+    for (auto &entry : entries)
+    {
+        if (entry.valid && entry.messageCount == messageCount && sameKey(entry, key))
+            return &entry;
+    }
+    return nullptr;
+}
+
+bool isKeystreamCached(const uint8_t key[SESSION_KEY_SIZE], uint32_t messageCount)
+{
+    return findEntry(key, messageCount) != nullptr;
+}
+
+KeystreamEntry *reserveKeystreamSlot(const uint8_t key[SESSION_KEY_SIZE])
+{
+    KeystreamEntry *freeEntry = nullptr;
+    for (auto &entry : entries)
+    {
+        if (entry.valid && sameKey(entry, key))
+            return &entry;
+        if (!entry.valid && !freeEntry)
+            freeEntry = &entry;
+    }
+    if (freeEntry)
+        return freeEntry;
+
+    KeystreamEntry *victim = &entries[nextVictim];
+    nextVictim = (nextVictim + 1) % KEYSTREAM_CACHE_SLOTS;
+    stats.evictions++;
+    return victim;
+}
+
+KeystreamEntry *takeKeystream(const uint8_t key[SESSION_KEY_SIZE], uint32_t messageCount, size_t length)
+{
+    KeystreamEntry *entry = length <= KEYSTREAM_CACHE_BYTES ? findEntry(key, messageCount) : nullptr;
+    if (entry)
+        stats.hits++;
+    else
+        stats.misses++;
+    return entry;
+}
+
+void releaseKeystream(KeystreamEntry *entry)
+{
+    memset(entry, 0, sizeof(*entry));
+}
+
+void forgetKeystreams(const uint8_t key[SESSION_KEY_SIZE])
+{
+    for (auto &entry : entries)
+    {
+        if (entry.valid && sameKey(entry, key))
+            releaseKeystream(&entry);
+    }
+}
+
+#else
+
+bool isKeystreamCached(const uint8_t key[SESSION_KEY_SIZE], uint32_t messageCount)
+{
+    return false;
+}
+
+KeystreamEntry *reserveKeystreamSlot(const uint8_t key[SESSION_KEY_SIZE])
+{
+    return nullptr;
+}
+
+KeystreamEntry *takeKeystream(const uint8_t key[SESSION_KEY_SIZE], uint32_t messageCount, size_t length)
+{
+    stats.misses++;
+    return nullptr;
+}
+
+void releaseKeystream(KeystreamEntry *entry)
+{
+}
+
+void forgetKeystreams(const uint8_t key[SESSION_KEY_SIZE])
+{
+}
+
+#endif
+
+void countPrecomputedKeystream()
+{
+    stats.precomputed++;
+}
+
+const KeystreamCacheStats &keystreamCacheStats()
+{
+    return stats;
+}
+
+void printKeystreamCacheStats()
+{
+    uint32_t lookups = stats.hits + stats.misses;
+    Serial.println("\n========= Keystream Cache =========");
+    Serial.println("🧮 Slots: " + String(KEYSTREAM_CACHE_SLOTS) + " (" +
+                   String((unsigned long)(KEYSTREAM_CACHE_SLOTS * sizeof(KeystreamEntry))) + " bytes)");
+    Serial.println("✅ Hits: " + String(stats.hits));
+    Serial.println("❌ Misses: " + String(stats.misses));
+    Serial.println("📈 Hit Rate: " + String(lookups ? 100UL * stats.hits / lookups : 0UL) + "%");
+    Serial.println("⏳ Precomputed: " + String(stats.precomputed));
+    Serial.println("♻️  Evictions: " + String(stats.evictions));
+    Serial.println("===================================\n");
+}
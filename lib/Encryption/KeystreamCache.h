@@ -0,0 +1,68 @@
+#ifndef KEYSTREAM_CACHE_H
+#define KEYSTREAM_CACHE_H
+
+#include <Arduino.h>
+#include "LoRaConfig.h"
+#include "EncryptionUtils.h"
+#include "Poly1305.h"
+
+// ========== Keystream cache ==========
+// ChaCha20 output for the next expected (key, counter) pairs, computed in idle loop
+// iterations (precomputeKeystream) so that encrypting or decrypting that frame is an XOR
+// plus the Poly1305 tag. Entries are matched on a copy of the key, and forgetKeystreams
+// wipes them when that key is ratcheted or reset. Fixed size, no heap.
+
+#define KEYSTREAM_CACHE_SLOTS (2 * LORA_KEYSTREAM_CACHE_PEERS) // One send and one receive entry per peer
+#define KEYSTREAM_CACHE_BYTES 64                               // Payload bytes covered (one ChaCha20 block)
+
+struct KeystreamEntry
+{
+    uint8_t key[SESSION_KEY_SIZE];
+    uint32_t messageCount;
+    bool valid;
+#if LORA_AEAD
+    uint8_t polyKey[POLY1305_KEY_SIZE]; // ChaCha20 block 0
+#endif
+    uint8_t stream[KEYSTREAM_CACHE_BYTES]; // Block 1 with LORA_AEAD, block 0 without
+};
+
+struct KeystreamCacheStats
+{
+    uint32_t hits;        // Frames encrypted/decrypted from a cached entry
+    uint32_t misses;      // Frames that computed their keystream inline
+    uint32_t precomputed; // Entries filled in idle time
+    uint32_t evictions;   // Valid entries overwritten for a different key
+};
+
+/**
+ * True if an entry for (key, messageCount) is ready. Does not touch the counters.
+ */
+bool isKeystreamCached(const uint8_t key[SESSION_KEY_SIZE], uint32_t messageCount);
+
+/**
+ * Slot to fill for `key`: the entry already holding this key (older counter), else a
+ * free one, else the next one round-robin. Returns nullptr if the cache is disabled.
+ */
+KeystreamEntry *reserveKeystreamSlot(const uint8_t key[SESSION_KEY_SIZE]);
+
+/**
+ * Cached entry for a frame of `length` bytes, or nullptr. Counts a hit or a miss.
+ */
+KeystreamEntry *takeKeystream(const uint8_t key[SESSION_KEY_SIZE], uint32_t messageCount, size_t length);
+
+/**
+ * Invalidates an entry once its counter has been used (a nonce is never used twice).
+ */
+void releaseKeystream(KeystreamEntry *entry);
+
+/**
+ * Invalidates every entry computed under `key`. Call before a key is ratcheted or wiped:
+ * the cache must not keep keystream (or a copy of the key) that is no longer in use.
+ */
+void forgetKeystreams(const uint8_t key[SESSION_KEY_SIZE]);
+
+void countPrecomputedKeystream();
+const KeystreamCacheStats &keystreamCacheStats();
+void printKeystreamCacheStats();
+
+#endif
@@ -0,0 +1,144 @@
+#include "Poly1305.h"
+
+static inline uint32_t load32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline void store32(uint8_t *p, uint32_t v)
+{
+    p[0] = v & 0xFF;
+    p[1] = (v >> 8) & 0xFF;
+    p[2] = (v >> 16) & 0xFF;
+    p[3] = v >> 24;
+}
+
+void poly1305Init(Poly1305 &ctx, const uint8_t key[POLY1305_KEY_SIZE])
+{
+    // r is clamped as required by the spec
+    ctx.r[0] = load32(key) & 0x3ffffff;
+    ctx.r[1] = (load32(key + 3) >> 2) & 0x3ffff03;
+    ctx.r[2] = (load32(key + 6) >> 4) & 0x3ffc0ff;
+    ctx.r[3] = (load32(key + 9) >> 6) & 0x3f03fff;
+    ctx.r[4] = (load32(key + 12) >> 8) & 0x00fffff;
+
+    for (uint8_t i = 0; i < 5; i++)
+        ctx.h[i] = 0;
+    for (uint8_t i = 0; i < 4; i++)
+        ctx.pad[i] = load32(key + 16 + 4 * i);
+
+    ctx.buffered = 0;
+}
+
+// Absorbs one 16-byte block; `hibit` is 1 << 24 for full blocks, 0 for the padded final block
+static void poly1305Block(Poly1305 &ctx, const uint8_t block[16], uint32_t hibit)
+{
+    const uint32_t r0 = ctx.r[0], r1 = ctx.r[1], r2 = ctx.r[2], r3 = ctx.r[3], r4 = ctx.r[4];
+    const uint32_t s1 = r1 * 5, s2 = r2 * 5, s3 = r3 * 5, s4 = r4 * 5;
+
+    uint32_t h0 = ctx.h[0] + (load32(block) & 0x3ffffff);
+    uint32_t h1 = ctx.h[1] + ((load32(block + 3) >> 2) & 0x3ffffff);
+    uint32_t h2 = ctx.h[2] + ((load32(block + 6) >> 4) & 0x3ffffff);
+    uint32_t h3 = ctx.h[3] + ((load32(block + 9) >> 6) & 0x3ffffff);
+    uint32_t h4 = ctx.h[4] + ((load32(block + 12) >> 8) | hibit);
+
+    uint64_t d0 = (uint64_t)h0 * r0 + (uint64_t)h1 * s4 + (uint64_t)h2 * s3 + (uint64_t)h3 * s2 + (uint64_t)h4 * s1;
+    uint64_t d1 = (uint64_t)h0 * r1 + (uint64_t)h1 * r0 + (uint64_t)h2 * s4 + (uint64_t)h3 * s3 + (uint64_t)h4 * s2;
+    uint64_t d2 = (uint64_t)h0 * r2 + (uint64_t)h1 * r1 + (uint64_t)h2 * r0 + (uint64_t)h3 * s4 + (uint64_t)h4 * s3;
+    uint64_t d3 = (uint64_t)h0 * r3 + (uint64_t)h1 * r2 + (uint64_t)h2 * r1 + (uint64_t)h3 * r0 + (uint64_t)h4 * s4;
+    uint64_t d4 = (uint64_t)h0 * r4 + (uint64_t)h1 * r3 + (uint64_t)h2 * r2 + (uint64_t)h3 * r1 + (uint64_t)h4 * r0;
+
+    uint32_t c;
+    c = (uint32_t)(d0 >> 26); h0 = (uint32_t)d0 & 0x3ffffff;
+    d1 += c; c = (uint32_t)(d1 >> 26); h1 = (uint32_t)d1 & 0x3ffffff;
+    d2 += c; c = (uint32_t)(d2 >> 26); h2 = (uint32_t)d2 & 0x3ffffff;
+    d3 += c; c = (uint32_t)(d3 >> 26); h3 = (uint32_t)d3 & 0x3ffffff;
+    d4 += c; c = (uint32_t)(d4 >> 26); h4 = (uint32_t)d4 & 0x3ffffff;
+    h0 += c * 5; c = h0 >> 26; h0 &= 0x3ffffff;
+    h1 += c;
+
+    ctx.h[0] = h0;
+    ctx.h[1] = h1;
+    ctx.h[2] = h2;
+    ctx.h[3] = h3;
+    ctx.h[4] = h4;
+}
+
+void poly1305Update(Poly1305 &ctx, const uint8_t *data, size_t length)
+{
+    if (ctx.buffered)
+    {
+        while (length > 0 && ctx.buffered < 16)
+        {
+            ctx.buffer[ctx.buffered++] = *data++;
+            length--;
+        }
+        if (ctx.buffered < 16)
+            return;
+        poly1305Block(ctx, ctx.buffer, 1UL << 24);
+        ctx.buffered = 0;
+    }
+
+    for (; length >= 16; data += 16, length -= 16)
+        poly1305Block(ctx, data, 1UL << 24);
+
+    while (length-- > 0)
+        ctx.buffer[ctx.buffered++] = *data++;
+}
+
+void poly1305Finish(Poly1305 &ctx, uint8_t tag[POLY1305_TAG_SIZE])
+{
+    if (ctx.buffered)
+    {
+        ctx.buffer[ctx.buffered++] = 1;
+        while (ctx.buffered < 16)
+            ctx.buffer[ctx.buffered++] = 0;
+        poly1305Block(ctx, ctx.buffer, 0);
+    }
+
+    uint32_t h0 = ctx.h[0], h1 = ctx.h[1], h2 = ctx.h[2], h3 = ctx.h[3], h4 = ctx.h[4];
+    uint32_t c;
+
+    // Fully carry h
+    c = h1 >> 26; h1 &= 0x3ffffff;
+    h2 += c; c = h2 >> 26; h2 &= 0x3ffffff;
+    h3 += c; c = h3 >> 26; h3 &= 0x3ffffff;
+    h4 += c; c = h4 >> 26; h4 &= 0x3ffffff;
+    h0 += c * 5; c = h0 >> 26; h0 &= 0x3ffffff;
+    h1 += c;
+
+    // g = h + -p; select h or g in constant time
+    uint32_t g0 = h0 + 5; c = g0 >> 26; g0 &= 0x3ffffff;
+    uint32_t g1 = h1 + c; c = g1 >> 26; g1 &= 0x3ffffff;
+    uint32_t g2 = h2 + c; c = g2 >> 26; g2 &= 0x3ffffff;
+    uint32_t g3 = h3 + c; c = g3 >> 26; g3 &= 0x3ffffff;
+    uint32_t g4 = h4 + c - (1UL << 26);
+
+    uint32_t mask = (g4 >> 31) - 1;
+    g0 &= mask; g1 &= mask; g2 &= mask; g3 &= mask; g4 &= mask;
+    mask = ~mask;
+    h0 = (h0 & mask) | g0;
+    h1 = (h1 & mask) | g1;
+    h2 = (h2 & mask) | g2;
+    h3 = (h3 & mask) | g3;
+    h4 = (h4 & mask) | g4;
+
+    // h = (h + pad) mod 2^128
+    h0 = (h0 | (h1 << 26)) & 0xffffffff;
+    h1 = ((h1 >> 6) | (h2 << 20)) & 0xffffffff;
+    h2 = ((h2 >> 12) | (h3 << 14)) & 0xffffffff;
+    h3 = ((h3 >> 18) | (h4 << 8)) & 0xffffffff;
+
+    uint64_t f;
+    f = (uint64_t)h0 + ctx.pad[0]; h0 = (uint32_t)f;
+    f = (uint64_t)h1 + ctx.pad[1] + (f >> 32); h1 = (uint32_t)f;
+    f = (uint64_t)h2 + ctx.pad[2] + (f >> 32); h2 = (uint32_t)f;
+    f = (uint64_t)h3 + ctx.pad[3] + (f >> 32); h3 = (uint32_t)f;
+
+    store32(tag, h0);
+    store32(tag + 4, h1);
+    store32(tag + 8, h2);
+    store32(tag + 12, h3);
+
+    memset(&ctx, 0, sizeof(ctx));
+}
@@ -0,0 +1,25 @@
+#ifndef POLY1305_H
+#define POLY1305_H
+
+#include <Arduino.h>
+
+#define POLY1305_KEY_SIZE 32
+#define POLY1305_TAG_SIZE 16
+
+/**
+ * Incremental Poly1305 one-time authenticator (RFC 8439), 26-bit limbs, no heap.
+ */
+struct Poly1305
+{
+    uint32_t r[5];
+    uint32_t h[5];
+    uint32_t pad[4];
+    uint8_t buffer[16];
+    uint8_t buffered;
+};
+
+void poly1305Init(Poly1305 &ctx, const uint8_t key[POLY1305_KEY_SIZE]);
+void poly1305Update(Poly1305 &ctx, const uint8_t *data, size_t length);
+void poly1305Finish(Poly1305 &ctx, uint8_t tag[POLY1305_TAG_SIZE]);
+
+#endif
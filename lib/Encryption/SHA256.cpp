@@ -0,0 +1,171 @@
+#include "SHA256.h"
+
+#define ROTR32(v, n) (((v) >> (n)) | ((v) << (32 - (n))))
+
+static const uint32_t roundConstants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+static void compress(uint32_t state[8], const uint8_t block[SHA256_BLOCK_SIZE])
+{
+    // 16-word rolling message schedule instead of the full 64-word one (saves 192 bytes of stack)
+    uint32_t w[16];
+    for (uint8_t i = 0; i < 16; i++)
+        w[i] = ((uint32_t)block[4 * i] << 24) | ((uint32_t)block[4 * i + 1] << 16) |
+               ((uint32_t)block[4 * i + 2] << 8) | block[4 * i + 3];
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+    uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+
+    for (uint8_t i = 0; i < 64; i++)
+    {
+        if (i >= 16)
+        {
+            uint32_t w15 = w[(i + 1) & 15], w2 = w[(i + 14) & 15];
+            uint32_t s0 = ROTR32(w15, 7) ^ ROTR32(w15, 18) ^ (w15 >> 3);
+            uint32_t s1 = ROTR32(w2, 17) ^ ROTR32(w2, 19) ^ (w2 >> 10);
+            w[i & 15] += s0 + w[(i + 9) & 15] + s1;
+        }
+
+        uint32_t t1 = h + (ROTR32(e, 6) ^ ROTR32(e, 11) ^ ROTR32(e, 25)) + ((e & f) ^ (~e & g)) +
+                      roundConstants[i] + w[i & 15];
+        uint32_t t2 = (ROTR32(a, 2) ^ ROTR32(a, 13) ^ ROTR32(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g;
+        g = f;
+        f = e;
+        e = d + t1;
+        d = c;
+        c = b;
+        b = a;
+        a = t1 + t2;
+    }
+
+    state[0] += a;
+    state[1] += b;
+    state[2] += c;
+    state[3] += d;
+    state[4] += e;
+    state[5] += f;
+    state[6] += g;
+    state[7] += h;
+}
+
+void sha256Init(Sha256 &ctx)
+{
+    static const uint32_t initialState[8] = {0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                             0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+    memcpy(ctx.state, initialState, sizeof(ctx.state));
+    ctx.length = 0;
+    ctx.buffered = 0;
+}
+
+void sha256Update(Sha256 &ctx, const uint8_t *data, size_t length)
+{
+    ctx.length += length;
+
+    while (length > 0)
+    {
+        size_t take = SHA256_BLOCK_SIZE - ctx.buffered;
+        if (take > length)
+            take = length;
+
+        memcpy(ctx.buffer + ctx.buffered, data, take);
+        ctx.buffered += take;
+        data += take;
+        length -= take;
+
+        if (ctx.buffered == SHA256_BLOCK_SIZE)
+        {
+            compress(ctx.state, ctx.buffer);
+            ctx.buffered = 0;
+        }
+    }
+}
+
+void sha256Finish(Sha256 &ctx, uint8_t digest[SHA256_DIGEST_SIZE])
+{
+    uint64_t bits = ctx.length * 8;
+
+    ctx.buffer[ctx.buffered++] = 0x80;
+    if (ctx.buffered > SHA256_BLOCK_SIZE - 8)
+    {
+        memset(ctx.buffer + ctx.buffered, 0, SHA256_BLOCK_SIZE - ctx.buffered);
+        compress(ctx.state, ctx.buffer);
+        ctx.buffered = 0;
+    }
+    memset(ctx.buffer + ctx.buffered, 0, SHA256_BLOCK_SIZE - 8 - ctx.buffered);
+    for (uint8_t i = 0; i < 8; i++)
+        ctx.buffer[SHA256_BLOCK_SIZE - 1 - i] = (bits >> (8 * i)) & 0xFF;
+    compress(ctx.state, ctx.buffer);
+
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        digest[4 * i] = ctx.state[i] >> 24;
+        digest[4 * i + 1] = ctx.state[i] >> 16;
+        digest[4 * i + 2] = ctx.state[i] >> 8;
+        digest[4 * i + 3] = ctx.state[i];
+    }
+
+    memset(&ctx, 0, sizeof(ctx));
+}
+
+void hmacSha256Init(HmacSha256 &ctx, const uint8_t *key, size_t keyLength)
+{
+    uint8_t pad[SHA256_BLOCK_SIZE] = {0};
+
+    if (keyLength > SHA256_BLOCK_SIZE)
+    {
+        sha256Init(ctx.inner);
+        sha256Update(ctx.inner, key, keyLength);
+        sha256Finish(ctx.inner, pad);
+    }
+    else
+    {
+        memcpy(pad, key, keyLength);
+    }
+
+    for (uint8_t i = 0; i < SHA256_BLOCK_SIZE; i++)
+    {
+        ctx.outerPad[i] = pad[i] ^ 0x5c;
+        pad[i] ^= 0x36;
+    }
+
+    sha256Init(ctx.inner);
+    sha256Update(ctx.inner, pad, SHA256_BLOCK_SIZE);
+    memset(pad, 0, sizeof(pad));
+}
+
+void hmacSha256Update(HmacSha256 &ctx, const uint8_t *data, size_t length)
+{
+    sha256Update(ctx.inner, data, length);
+}
+
+void hmacSha256Finish(HmacSha256 &ctx, uint8_t mac[SHA256_DIGEST_SIZE])
+{
+    uint8_t innerDigest[SHA256_DIGEST_SIZE];
+    sha256Finish(ctx.inner, innerDigest);
+
+    Sha256 outer;
+    sha256Init(outer);
+    sha256Update(outer, ctx.outerPad, SHA256_BLOCK_SIZE);
+    sha256Update(outer, innerDigest, SHA256_DIGEST_SIZE);
+    sha256Finish(outer, mac);
+
+    memset(innerDigest, 0, sizeof(innerDigest));
+    memset(&ctx, 0, sizeof(ctx));
+}
+
+void hmacSha256(const uint8_t *key, size_t keyLength, const uint8_t *data, size_t length,
+                uint8_t mac[SHA256_DIGEST_SIZE])
+{
+    HmacSha256 ctx;
+    hmacSha256Init(ctx, key, keyLength);
+    hmacSha256Update(ctx, data, length);
+    hmacSha256Finish(ctx, mac);
+}
@@ -0,0 +1,44 @@
+#ifndef SHA256_H
+#define SHA256_H
+
+#include <Arduino.h>
+
+#define SHA256_DIGEST_SIZE 32
+#define SHA256_BLOCK_SIZE 64
+
+/**
+ * Incremental SHA-256 (FIPS 180-4), no heap.
+ */
+struct Sha256
+{
+    uint32_t state[8];
+    uint64_t length; // Bytes hashed so far
+    uint8_t buffer[SHA256_BLOCK_SIZE];
+    uint8_t buffered;
+};
+
+void sha256Init(Sha256 &ctx);
+void sha256Update(Sha256 &ctx, const uint8_t *data, size_t length);
+void sha256Finish(Sha256 &ctx, uint8_t digest[SHA256_DIGEST_SIZE]);
+
+/**
+ * Incremental HMAC-SHA256 (RFC 2104): the inner hash runs in `inner`, the outer key pad
+ * is kept until hmacSha256Finish.
+ */
+struct HmacSha256
+{
+    Sha256 inner;
+    uint8_t outerPad[SHA256_BLOCK_SIZE];
+};
+
+void hmacSha256Init(HmacSha256 &ctx, const uint8_t *key, size_t keyLength);
+void hmacSha256Update(HmacSha256 &ctx, const uint8_t *data, size_t length);
+void hmacSha256Finish(HmacSha256 &ctx, uint8_t mac[SHA256_DIGEST_SIZE]);
+
+/**
+ * One-shot HMAC-SHA256.
+ */
+void hmacSha256(const uint8_t *key, size_t keyLength, const uint8_t *data, size_t length,
+                uint8_t mac[SHA256_DIGEST_SIZE]);
+
+#endif
@@ -0,0 +1,91 @@
+#include "SecureRandom.h"
+#include "ChaCha20.h"
+
+static uint8_t generatorKey[CHACHA20_KEY_SIZE];
+static uint32_t generatorCounter = 0;
+static bool generatorSeeded = false;
+
+// Collects timing jitter and the low bits of the (floating) analog inputs
+static void collectEntropy(uint32_t pool[8])
+{
+    for (uint8_t i = 0; i < 8; i++)
+    {
+        uint32_t word = micros();
+        for (uint8_t j = 0; j < 16; j++)
+            word = (word << 2 | word >> 30) ^ (analogRead(A0 + (j % 6)) & 0x03) ^ micros();
+        pool[i] ^= word;
+    }
+}
+
+// Produces one block and replaces the key with its first half (fast key erasure)
+static void nextBlock(uint8_t output[CHACHA20_KEY_SIZE])
+{
+    static const uint8_t nonce[CHACHA20_NONCE_SIZE] = {'s', 'e', 'c', 'u', 'r', 'e', '-', 'r', 'n', 'g', 0, 0};
+    uint32_t block[16];
+    chacha20Block(generatorKey, nonce, generatorCounter++, block);
+
+    memcpy(generatorKey, block, CHACHA20_KEY_SIZE);
+    memcpy(output, block + 8, CHACHA20_KEY_SIZE);
+    memset(block, 0, sizeof(block));
+}
+
+static void ensureSeeded()
+{
+    if (generatorSeeded)
+        return;
+
+    uint32_t pool[8] = {0};
+    collectEntropy(pool);
+    for (uint8_t i = 0; i < 8; i++)
+        for (uint8_t j = 0; j < 4; j++)
+            generatorKey[4 * i + j] ^= (pool[i] >> (8 * j)) & 0xFF;
+
+    memset(pool, 0, sizeof(pool));
+    generatorSeeded = true;
+}
+
+void secureRandomAddEntropy(uint32_t value)
+{
+    ensureSeeded();
+    for (uint8_t i = 0; i < 4; i++)
+        generatorKey[i] ^= (value >> (8 * i)) & 0xFF;
+
+    uint8_t discard[CHACHA20_KEY_SIZE];
+    nextBlock(discard);
+    memset(discard, 0, sizeof(discard));
+}
+
+void secureRandomBytes(uint8_t *output, size_t length)
+{
+    ensureSeeded();
+
+    uint8_t block[CHACHA20_KEY_SIZE];
+    while (length > 0)
+    {
+        nextBlock(block);
+        size_t take = length < sizeof(block) ? length : sizeof(block);
+        memcpy(output, block, take);
+        output += take;
+        length -= take;
+    }
+    memset(block, 0, sizeof(block));
+}
+
+uint32_t secureRandomRange(uint32_t min, uint32_t max)
+{
+    uint32_t span = max - min;
+    if (span == 0)
+        return min;
+
+    // Rejection sampling: drop the top partial range so every value is equally likely
+    uint32_t limit = 0xFFFFFFFFUL - (0xFFFFFFFFUL % span);
+    uint32_t value;
+    do
+    {
+        uint8_t bytes[4];
+        secureRandomBytes(bytes, sizeof(bytes));
+        value = (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+    } while (value >= limit);
+
+    return min + value % span;
+}
@@ -0,0 +1,26 @@
+#ifndef SECURE_RANDOM_H
+#define SECURE_RANDOM_H
+
+#include <Arduino.h>
+
+// ========== Node-wide random generator ==========
+// ChaCha20 keystream generator, seeded on first use from ADC noise and timer jitter. Every
+// request rekeys it from its own output, so earlier outputs cannot be recomputed later.
+// Use it instead of random()/randomSeed() for anything an attacker must not predict.
+
+/**
+ * Mixes extra material (e.g. the EEPROM seed) into the generator state.
+ */
+void secureRandomAddEntropy(uint32_t value);
+
+/**
+ * Fills `output` with `length` random bytes.
+ */
+void secureRandomBytes(uint8_t *output, size_t length);
+
+/**
+ * Uniform random value in [min, max).
+ */
+uint32_t secureRandomRange(uint32_t min, uint32_t max);
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef LORA_AIRTIME_H
+#define LORA_AIRTIME_H
+
+#include <Arduino.h>
+#include "LoRaConfig.h"
+
+/**
+ * Time-on-air of a single LoRa packet in microseconds (Semtech AN1200.13 formula).
+ * Assumes explicit header mode; low data rate optimisation is enabled automatically
+ * when the symbol time exceeds 16 ms, as the LoRa library does.
+ */
+inline uint32_t loraTimeOnAirMicros(size_t payloadLength,
+                                    uint8_t spreadingFactor = LORA_SPREADING_FACTOR,
+                                    long bandwidth = LORA_SIGNAL_BANDWIDTH,
+                                    uint8_t codingRateDenom = LORA_CODING_RATE_DENOM)
+{
+    float symbolMicros = (float)(1UL << spreadingFactor) * 1e6f / bandwidth;
+    int lowDataRate = symbolMicros > 16000.0f ? 1 : 0;
+
+    int numerator = 8 * (int)payloadLength - 4 * spreadingFactor + 28 + 16 * LORA_CRC_ENABLED;
+    int denominator = 4 * (spreadingFactor - 2 * lowDataRate);
+    int payloadSymbols = 8;
+    if (numerator > 0)
+        payloadSymbols += ((numerator + denominator - 1) / denominator) * codingRateDenom;
+
+    float preambleSymbols = LORA_PREAMBLE_LENGTH + 4.25f;
+    return (uint32_t)((preambleSymbols + payloadSymbols) * symbolMicros);
+}
+
+#endif
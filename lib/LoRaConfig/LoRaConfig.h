@@ -6,4 +6,180 @@
 #define LORA_DIO0 2     // DIO0 pin (interrupt)
 #define LORA_BAND 915E6 // Frequency (Australia = 915 MHz)
 
+// Modem settings (LoRa library defaults); also used for time-on-air estimates
+#define LORA_SPREADING_FACTOR 7     // 6..12
+#define LORA_SIGNAL_BANDWIDTH 125E3 // Hz
+#define LORA_CODING_RATE_DENOM 5    // 4/5
+#define LORA_PREAMBLE_LENGTH 8      // Symbols
+#define LORA_CRC_ENABLED 0          // Payload CRC is off in the LoRa library by default
+
+#define LORA_MAX_FRAME_LEN 255 // SX127x FIFO limit for a single packet
+
+// Wire format: 0 = colon-delimited ASCII frames, 1 = compact binary frames (BinaryFrame.h)
+// Override per build with: build_flags = -D LORA_BINARY_FRAMES=1
+#ifndef LORA_BINARY_FRAMES
+#define LORA_BINARY_FRAMES 0
+#endif
+
+// Encrypted payloads (CHAL, RESP, MSG): 1 = ChaCha20-Poly1305 with a 16-byte tag over the
+// frame header, 0 = unauthenticated ChaCha20 stream cipher. All nodes must agree.
+#ifndef LORA_AEAD
+#define LORA_AEAD 1
+#endif
+
+// Key exchange: 1 = X25519 with 32-byte keys (PK payload is base64, raw in binary frames),
+// 0 = legacy 31-bit modexp Diffie-Hellman (PK payload is a decimal number). All nodes must agree.
+#ifndef LORA_X25519
+#define LORA_X25519 1
+#endif
+
+// Session resumption: 1 = keep an encrypted session ticket per peer in EEPROM and, after a
+// reboot, re-establish with one RESUME/RESUMED round trip instead of CLEAR + full handshake
+#ifndef LORA_SESSION_RESUMPTION
+#define LORA_SESSION_RESUMPTION 0
+#endif
+
+// Broadcast key announcement: 1 = one node-wide key pair; the RX announces its public key to
+// ALL once for every peer that answered PING, instead of one PK frame per peer
+#ifndef LORA_BROADCAST_PK
+#define LORA_BROADCAST_PK 0
+#endif
+
+// Handshake: 1 = the RX starts with KX_INIT/KX_CONFIRM (keys + transcript MAC, one round trip),
+// 0 = PK/ACK/CHAL/RESP/AUTH_SUCCESS. Every node answers KX_INIT either way; the RX falls back
+// to the PK exchange if a peer never confirms.
+#ifndef LORA_FAST_HANDSHAKE
+#define LORA_FAST_HANDSHAKE 0
+#endif
+
+// Traffic key ratchet (KeySchedule.h): each direction's key moves one epoch forward every
+// LORA_REKEY_FRAMES counter values. A sender whose epoch is older than LORA_REKEY_INTERVAL_MS
+// skips its counter to the next epoch boundary, so quiet links rekey on time as well.
+// Receivers follow at most LORA_REKEY_MAX_SKIP epochs per frame. All nodes must agree on
+// LORA_REKEY_FRAMES.
+#ifndef LORA_REKEY_FRAMES
+#define LORA_REKEY_FRAMES 256
+#endif
+
+#ifndef LORA_REKEY_INTERVAL_MS
+#define LORA_REKEY_INTERVAL_MS 3600000UL // 1 hour
+#endif
+
+#ifndef LORA_REKEY_MAX_SKIP
+#define LORA_REKEY_MAX_SKIP 16
+#endif
+
+// Keystream cache (KeystreamCache.h): idle loop iterations precompute the ChaCha20 blocks for
+// the next frame to and from up to this many peers (2 entries, about 140 bytes each, per
+// peer), so the send/receive path only XORs. 0 disables the cache.
+#ifndef LORA_KEYSTREAM_CACHE_PEERS
+#define LORA_KEYSTREAM_CACHE_PEERS 4
+#endif
+
+// Peer table slots (NodeManager.h), 259 bytes each with X25519 (175 legacy); must be a
+// power of two. 64 peers take 16.6 KB of the Uno R4's 32 KB, the most that fits. When
+// full, the least recently heard peer that is not authenticated is replaced.
+#ifndef LORA_MAX_PEERS
+#define LORA_MAX_PEERS 16
+#endif
+
+// Peers whose device ID has no compact address (BinaryFrame.h), such as "RX001" or "TXA",
+// keep their full ID in one of this many 20-byte name slots of the peer table. They can
+// pair over ASCII frames only.
+#ifndef LORA_MAX_NAMED_PEERS
+#define LORA_MAX_NAMED_PEERS 4
+#endif
+
+// Peers that are not authenticated and have not been heard for this long are removed
+#ifndef LORA_PEER_IDLE_TIMEOUT_MS
+#define LORA_PEER_IDLE_TIMEOUT_MS 120000UL // 2 minutes
+#endif
+
+// Initial TTL of control frames (PING, PONG, PK, ACK, CLEAR, AUTH_SUCCESS, KX_*). 0 keeps
+// them direct-only in the 4-part ASCII layout; above 0 every frame carries TTL and a
+// sequence number, so relays forward handshakes and nodes out of direct range can join.
+// Changes the ASCII wire format, so every node must use the same setting.
+#ifndef LORA_CONTROL_TTL
+#define LORA_CONTROL_TTL 0
+#endif
+
+// Receive path (LoRaReceive.h): 1 = the DIO0 interrupt copies each packet into a ring of
+// LORA_RX_RING_SLOTS frames (power of two, about 270 bytes each) that the loop drains, so
+// packets arriving while the loop blocks (transmit, delay, Serial) are kept. 0 = poll
+// parsePacket() once per loop.
+#ifndef LORA_RX_INTERRUPT
+#define LORA_RX_INTERRUPT 1
+#endif
+
+#ifndef LORA_RX_RING_SLOTS
+#define LORA_RX_RING_SLOTS 4
+#endif
+
+// Relay queue (RelayQueue.h): frames a relay holds during their random backoff, about
+// 270 bytes each. When all slots are taken, newly heard frames are not relayed.
+#ifndef LORA_RELAY_QUEUE_SLOTS
+#define LORA_RELAY_QUEUE_SLOTS 8
+#endif
+
+// Relay backoff (RelayBackoff.h): 0 = uniform random in [MIN, MAX), 1 = weighted by the
+// SNR/RSSI of the received copy so far-away relays forward first and near ones cancel.
+// JITTER must exceed a frame's airtime for a later relay to overhear an earlier one.
+#ifndef LORA_RELAY_BACKOFF
+#define LORA_RELAY_BACKOFF 1
+#endif
+
+#ifndef LORA_RELAY_BACKOFF_MIN_MS
+#define LORA_RELAY_BACKOFF_MIN_MS 300
+#endif
+
+#ifndef LORA_RELAY_BACKOFF_MAX_MS
+#define LORA_RELAY_BACKOFF_MAX_MS 1000
+#endif
+
+#ifndef LORA_RELAY_BACKOFF_JITTER_MS
+#define LORA_RELAY_BACKOFF_JITTER_MS 100
+#endif
+
+// Relay aggregation (AggregateFrame.h): when a queued MSG frame is due, queued MSG frames for
+// the same receiver due within the window go out with it in one packet, sharing preamble
+// and header. Every node unpacks aggregates whatever this setting.
+#ifndef LORA_RELAY_AGGREGATION
+#define LORA_RELAY_AGGREGATION 0
+#endif
+
+#ifndef LORA_RELAY_AGGREGATE_WINDOW_MS
+#define LORA_RELAY_AGGREGATE_WINDOW_MS 250
+#endif
+
+// Relay duplicate cache (DedupCache.h): messages remembered, 12 bytes each; must be a power
+// of two. A message heard again within LORA_DEDUP_EXPIRY_MS is not relayed a second time.
+#ifndef LORA_DEDUP_SLOTS
+#define LORA_DEDUP_SLOTS 64
+#endif
+
+#ifndef LORA_DEDUP_EXPIRY_MS
+#define LORA_DEDUP_EXPIRY_MS 30000UL // 30 seconds
+#endif
+
+// Learned next-hop routing (RouteTable.h): frames name the relay that should forward them,
+// learned from the path earlier frames of the destination took; unknown destinations are
+// flooded. Adds hop/via fields to relayable frames, so every node must use the same setting.
+#ifndef LORA_ROUTING
+#define LORA_ROUTING 0
+#endif
+
+#ifndef LORA_ROUTE_SLOTS
+#define LORA_ROUTE_SLOTS 16
+#endif
+
+#ifndef LORA_ROUTE_EXPIRY_MS
+#define LORA_ROUTE_EXPIRY_MS 120000UL // 2 minutes
+#endif
+
+// Weakest link (linkQuality, 0..255) used as a next hop; weaker frames are still relayed
+// but teach no route.
+#ifndef LORA_ROUTE_MIN_QUALITY
+#define LORA_ROUTE_MIN_QUALITY 48
+#endif
+
 #endif
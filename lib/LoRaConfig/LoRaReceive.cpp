@@ -0,0 +1,110 @@
+#include "LoRaReceive.h"
+#include <LoRa.h>
+
+static volatile ReceiveStats stats = {0, 0, 0};
+
+#if LORA_RX_INTERRUPT
+// Receive ring: single producer (the DIO0 handler), single consumer (receiveFrame in the
+// loop). Each side writes only its own free-running index, so no lock is needed; the
+// barriers publish a slot only after it is completely written or read.
+static LoRaFrame ring[RX_RING_SLOTS];
+static volatile uint8_t ringHead = 0; // Written by the handler
+static volatile uint8_t ringTail = 0; // Written by the loop
+#endif
+
+void readFrame(int packetSize, LoRaFrame &frame)
+{
+    frame.receivedAt = micros();
+
+    uint8_t length = packetSize > LORA_MAX_FRAME_LEN ? LORA_MAX_FRAME_LEN : (uint8_t)packetSize;
+    for (uint8_t i = 0; i < length; i++)
+        frame.data[i] = (uint8_t)LoRa.read();
+    frame.length = length;
+
+    frame.rssi = LoRa.packetRssi();
+    frame.snr = LoRa.packetSnr();
+}
+
+#if LORA_RX_INTERRUPT
+// Runs in interrupt context: no Serial, no allocation
+static void onFrameReceived(int packetSize)
+{
+    uint8_t head = ringHead;
+    uint8_t waiting = head - ringTail;
+    if (waiting == RX_RING_SLOTS)
+    {
+        stats.overflows++; // The radio FIFO is simply overwritten by the next packet
+        return;
+    }
+
+    readFrame(packetSize, ring[head & (RX_RING_SLOTS - 1)]);
+    __sync_synchronize();
+    ringHead = head + 1;
+
+    stats.received++;
+    if (waiting + 1 > stats.highWater)
+        stats.highWater = waiting + 1;
+}
+
+void startFrameReceiver()
+{
+    LoRa.onReceive(onFrameReceived);
+    LoRa.receive();
+}
+
+void stopFrameReceiver()
+{
+    noInterrupts();
+    LoRa.idle();
+    interrupts();
+}
+#endif
+
+bool receiveFrame(LoRaFrame &frame)
+{
+#if LORA_RX_INTERRUPT
+    uint8_t tail = ringTail;
+    if (tail == ringHead)
+        return false;
+
+    __sync_synchronize();
+    frame = ring[tail & (RX_RING_SLOTS - 1)];
+    __sync_synchronize();
+    ringTail = tail + 1;
+    return true;
+#else
+    int packetSize = LoRa.parsePacket();
+    if (packetSize <= 0)
+        return false;
+
+    readFrame(packetSize, frame);
+    stats.received++;
+    return true;
+#endif
+}
+
+ReceiveStats receiveStats()
+{
+    noInterrupts();
+    ReceiveStats snapshot = {stats.received, stats.overflows, stats.highWater};
+    interrupts();
+    return snapshot;
+}
+
+void printReceiveStats()
+{
+    ReceiveStats snapshot = receiveStats();
+
+    Serial.println("\n========= Radio Receive =========");
+#if LORA_RX_INTERRUPT
+    uint8_t waiting = ringHead - ringTail;
+    Serial.println("📡 Mode: DIO0 interrupt, ring " + String(waiting) + "/" + String(RX_RING_SLOTS) +
+                   " (high water " + String(snapshot.highWater) + ")");
+    Serial.println("📥 Received: " + String(snapshot.received));
+    Serial.println("🌊 Overflows (ring full): " + String(snapshot.overflows));
+#else
+    Serial.println("📡 Mode: polling");
+    Serial.println("📥 Received: " + String(snapshot.received));
+#endif
+    Serial.println("=================================\n");
+}
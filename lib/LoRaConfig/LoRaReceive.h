@@ -0,0 +1,63 @@
+#ifndef LORA_RECEIVE_H
+#define LORA_RECEIVE_H
+
+#include <Arduino.h>
+#include "LoRaConfig.h"
+
+/**
+ * A received packet copied out of the radio FIFO together with its link metadata.
+ * The buffer is preallocated, so receiving never touches the heap.
+ */
+struct LoRaFrame
+{
+    uint8_t data[LORA_MAX_FRAME_LEN];
+    uint8_t length = 0;
+    int16_t rssi = 0;             // dBm
+    float snr = 0;                // dB
+    unsigned long receivedAt = 0; // micros() when the packet was picked up
+};
+
+/**
+ * Copies a packet of `packetSize` bytes (as reported by parsePacket/onReceive) from the
+ * FIFO into `frame` in one pass and records RSSI, SNR and arrival time.
+ * Uses no Serial output or allocation, so it can also run from the DIO0 receive callback.
+ */
+void readFrame(int packetSize, LoRaFrame &frame);
+
+/**
+ * Takes the next received packet into `frame` and returns true, or returns false if none
+ * is waiting. With LORA_RX_INTERRUPT it pops the oldest frame of the receive ring; otherwise
+ * it polls the radio.
+ */
+bool receiveFrame(LoRaFrame &frame);
+
+#define RX_RING_SLOTS LORA_RX_RING_SLOTS
+
+static_assert((RX_RING_SLOTS & (RX_RING_SLOTS - 1)) == 0 && RX_RING_SLOTS >= 2 && RX_RING_SLOTS <= 128,
+              "LORA_RX_RING_SLOTS must be a power of two from 2 to 128");
+
+struct ReceiveStats
+{
+    uint32_t received;  // Packets taken from the radio
+    uint32_t overflows; // Packets dropped because the ring was full (LORA_RX_INTERRUPT)
+    uint8_t highWater;  // Most frames waiting in the ring at once
+};
+
+#if LORA_RX_INTERRUPT
+/**
+ * Puts the radio into continuous receive mode with the DIO0 handler that fills the ring.
+ * Called by setupLoRa when LORA_RX_INTERRUPT is set, and after every transmission.
+ */
+void startFrameReceiver();
+
+/**
+ * Takes the radio out of receive mode before a transmission, so the DIO0 handler cannot
+ * run inside the transmit SPI transfers.
+ */
+void stopFrameReceiver();
+#endif
+
+ReceiveStats receiveStats();
+void printReceiveStats();
+
+#endif
@@ -4,6 +4,7 @@
 #include <SPI.h>
 #include <LoRa.h>
 #include "LoRaConfig.h"
+#include "LoRaReceive.h"
 
 bool setupLoRa()
 {
@@ -15,6 +16,14 @@ bool setupLoRa()
         return false;
     }
 
+    LoRa.setSpreadingFactor(LORA_SPREADING_FACTOR);
+    LoRa.setSignalBandwidth(LORA_SIGNAL_BANDWIDTH);
+    LoRa.setCodingRate4(LORA_CODING_RATE_DENOM);
+    LoRa.setPreambleLength(LORA_PREAMBLE_LENGTH);
+#if LORA_RX_INTERRUPT
+    startFrameReceiver();
+#endif
+
     Serial.println("LoRa init succeeded.");
     return true;
 }
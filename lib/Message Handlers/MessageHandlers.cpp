@@ -1,48 +1,54 @@
 #include "MessageHandlers.h"
 
+static void startKeyExchange(NodeState *peer);
+
 /**
  * Handles PING messages by replying with PONG.
  */
 void handlePing(const LoRaMessage &msg)
 {
-    String pong = createMessage("PONG", id, msg.senderId, "READY");
-    LoRa.beginPacket();
-    LoRa.print(pong);
-    LoRa.endPacket();
+    touchPeer(msg.senderId);
+    sendMessage("PONG", id, msg.senderId, "READY");
 }
 
 /**
  * Handles incoming public key (PK) exchange from peer.
  * Responds with our PK and computes shared session key.
  */
-void handlePkExchange(const LoRaMessage &msg, uint32_t seed)
+void handlePkExchange(const LoRaMessage &msg)
 {
+    // Broadcast announcements are answered by TX nodes only
+    if (msg.receiverId == "ALL")
+        return;
+
     NodeState *peer = findOrCreatePeer(msg.senderId);
-    peer->remotePublicKey = msg.payload.toInt();
+    if (!peer)
+        return;
+
+    if (!storeRemotePublicKey(peer, msg.payload))
+    {
+        Serial.println("⚠️  Malformed PK from " + msg.senderId + ". Ignoring.");
+        return;
+    }
     peer->pkReceived = true;
+    markPeerAnnouncementAcked(peer);
 
-    if (peer->privateKey == 0 || peer->publicKey == 0)
+    if (!hasLocalKeys(peer))
     {
-        peer->privateKey = generatePrivateKey(seed);
-        peer->publicKey = generatePublicKey(peer->privateKey);
-        Serial.println("PRIVATE KEY: " + String(peer->privateKey));
-        Serial.println("PUBLIC KEY: " + String(peer->publicKey));
+        createLocalKeys(peer, seed);
+        Serial.println("PUBLIC KEY: " + publicKeyPayload(peer));
     }
 
     if (!peer->pkSent)
     {
-        String pkMsg = createMessage("PK", id, msg.senderId, String(peer->publicKey));
-        LoRa.beginPacket();
-        LoRa.print(pkMsg);
-        LoRa.endPacket();
+        sendMessage("PK", id, msg.senderId, publicKeyPayload(peer));
         peer->pkSent = true;
     }
 
-    if (peer->sharedSessionKey == 0 && peer->privateKey && peer->remotePublicKey)
+    if (peer->sharedSessionKey == 0 && deriveSessionKey(peer, id))
     {
-        peer->sharedSessionKey = generateSharedKey(peer->remotePublicKey, peer->privateKey);
         Serial.println(" \n\n======== STEP 5: Rx Recieves PK from TX; responds with its ACK message and Generates Shared Session Key ========");
-        Serial.println("SHARED SESSION KEY: " + String(peer->sharedSessionKey));
+        Serial.println("SHARED SESSION KEY: " + sessionKeyString(peer));
         Serial.println("==========================================================");
     }
 
@@ -57,31 +63,29 @@ void handleAck(const LoRaMessage &msg)
 {
     Serial.println("Received ACK from " + msg.senderId);
     NodeState *peer = findOrCreatePeer(msg.senderId);
+    if (!peer)
+        return;
 
     if (!peer->ackReceived)
     {
-        markPeerAckReceived(peer->id);
+        markPeerAckReceived(peer);
 
         if (!peer->ackSent)
         {
-            String ack = createMessage("ACK", id, msg.senderId, "OK");
-            LoRa.beginPacket();
-            LoRa.print(ack);
-            LoRa.endPacket();
+            sendMessage("ACK", id, msg.senderId, "OK");
             peer->ackSent = true;
-            Serial.println("✅ Sent ACK in response to TX's ACK to " + peer->id);
+            Serial.println("✅ Sent ACK in response to TX's ACK to " + peerId(peer));
         }
 
-        if (peer->sharedSessionKey == 0 && peer->privateKey && peer->remotePublicKey)
+        if (peer->sharedSessionKey == 0 && deriveSessionKey(peer, id))
         {
-            peer->sharedSessionKey = generateSharedKey(peer->privateKey, peer->remotePublicKey);
-            Serial.println("✅ Shared session key with " + peer->id + ": " + String(peer->sharedSessionKey));
+            Serial.println("✅ Shared session key with " + peerId(peer) + ": " + sessionKeyString(peer));
         }
 
-        if (isPeerDHComplete(peer->id) && peer->state != PeerState::SECURE_COMM)
+        if (isPeerDHComplete(peer) && peer->state != PeerState::SECURE_COMM)
         {
             peer->state = PeerState::SECURE_COMM;
-            Serial.println("🤝 [RX] DH Exchange Complete with " + peer->id);
+            Serial.println("🤝 [RX] DH Exchange Complete with " + peerId(peer));
             printPeerStatus();
             delay(300);
             handleAuthChallenge(peer, id, ttl);
@@ -89,6 +93,37 @@ void handleAck(const LoRaMessage &msg)
     }
 }
 
+/**
+ * Broadcasts our public key once for every peer queued by handlePong (LORA_BROADCAST_PK).
+ * Each peer answers with its own PK and ACK; silent peers are re-announced and eventually dropped.
+ */
+void announcePublicKey()
+{
+    uint8_t covered = preparePkAnnouncement();
+    if (covered == 0)
+        return;
+
+    NodeState *first = nullptr;
+    for (auto &peer : peers)
+    {
+        if (peer.awaitingAnnouncement)
+        {
+            first = &peer;
+            break;
+        }
+    }
+
+    String payload = publicKeyPayload(first);
+    String pkMsg = createMessage("PK", id, "ALL", payload);
+    sendMessage("PK", id, "ALL", payload);
+
+    Serial.println(" \n======== STEP 3: Rx Announces DH Public Key to ALL ========");
+    Serial.println("Peers covered: " + String(covered));
+    Serial.println("PUBLIC KEY: " + payload);
+    Serial.println("[ " + pkMsg + " ] ");
+    Serial.println("=======================================================");
+}
+
 /**
  * Handles a CLEAR request (peer wants to reset handshake).
  */
@@ -97,14 +132,18 @@ void handleClear(const LoRaMessage &msg)
     if (msg.receiverId == "ALL" || msg.receiverId == id)
     {
         Serial.println("⚠️  Received CLEAR from " + msg.senderId + ". Removing peer.");
-        NodeState *peer = findOrCreatePeer(msg.senderId);
-        resetPeer(peer);
+        peers.remove(peers.find(msg.senderId));
+#if LORA_SESSION_RESUMPTION
+        eraseSessionTicket(msg.senderId);
+#endif
     }
 }
 
 void handleMsg(const LoRaMessage &msg)
 {
     NodeState *peer = findOrCreatePeer(msg.senderId);
+    if (!peer)
+        return;
 
     if (peer->state != PeerState::AUTHENTICATED)
     {
@@ -112,7 +151,404 @@ void handleMsg(const LoRaMessage &msg)
         return;
     }
 
-    String decrypted = decryptString(msg.payload, peer->sharedSessionKey, msg.messageCount);
+    // Replayed and stale counters are dropped (and only counted) before any decryption
+    if (isReplayedCounter(peer, msg.messageCount))
+    {
+        peer->replaysDropped++;
+        return;
+    }
+
+    // Tag is checked before anything is decrypted or printed
+    String decrypted;
+    if (!decryptFromPeer(peer, msg.payload, msg.messageCount,
+                         createAssociatedData(msg.type, msg.senderId, msg.receiverId, msg.messageCount), decrypted))
+    {
+        Serial.println("❌ Dropped MSG from " + msg.senderId + ": authentication tag mismatch");
+        return;
+    }
+    acceptCounter(peer, msg.messageCount);
+
     Serial.println("🔓 [" + String(millis() / 1000) + "] From -> " + msg.senderId + " : " + msg.receiverId + " : " + msg.ttl + " : " + msg.messageCount + " : " + msg.payload);
     Serial.println("Decrypted Message: " + decrypted);
+
+#if LORA_SESSION_RESUMPTION
+    // Track the sender's counter so a resumed session never restarts below it
+    if (peer->messageCount <= (uint32_t)msg.messageCount)
+    {
+        peer->messageCount = msg.messageCount + 1;
+        refreshSessionTicket(peer, seed);
+    }
+#endif
+}
+
+/**
+ * Handles PONG by starting the DH key exchange with the responding peer.
+ */
+void handlePong(const LoRaMessage &msg)
+{
+    NodeState *peer = findOrCreatePeer(msg.senderId);
+    if (!peer)
+        return;
+
+#if LORA_FAST_HANDSHAKE
+    // Peers that never confirmed a KX_INIT (handshakeAttempts left at the limit) use the PK exchange
+    if (peer->state == PeerState::IDLE && peer->handshakeAttempts == 0)
+    {
+        startFastHandshake(peer, id, seed);
+        return;
+    }
+    if (peer->state == PeerState::KX_SENT)
+        return;
+#endif
+
+    startKeyExchange(peer);
+}
+
+/**
+ * RX: starts the PK/ACK handshake, unless our PK already went out.
+ */
+static void startKeyExchange(NodeState *peer)
+{
+#if LORA_BROADCAST_PK
+    // The next broadcast PK (announcePublicKey) covers this peer
+    if (!peer->pkReceived && !peer->awaitingAnnouncement)
+    {
+        createLocalKeys(peer, seed);
+        queuePeerForAnnouncement(peer);
+        Serial.println("📣 " + peerId(peer) + " queued for the next PK announcement");
+    }
+    return;
+#endif
+
+    if (!peer->pkSent)
+    {
+        Serial.println(" \n======== STEP 3: Rx Initiating DH Key Exchange ========");
+        createLocalKeys(peer, seed);
+        String pkMsg = createMessage("PK", id, peerId(peer), publicKeyPayload(peer));
+        sendMessage("PK", id, peerId(peer), publicKeyPayload(peer));
+        peer->pkSent = true;
+
+        Serial.println("PUBLIC KEY: " + publicKeyPayload(peer));
+        Serial.println("[ " + pkMsg + " ] ");
+        Serial.println("=======================================================");
+    }
+}
+
+/**
+ * Handles CHAL by (re)issuing our own challenge to the peer.
+ */
+void handleChal(const LoRaMessage &msg)
+{
+    NodeState *peer = findOrCreatePeer(msg.senderId);
+    if (!peer)
+        return;
+    handleAuthChallenge(peer, id, ttl);
+}
+
+/**
+ * Handles RESP by verifying the peer's answer to our challenge.
+ */
+void handleResp(const LoRaMessage &msg)
+{
+    NodeState *peer = findOrCreatePeer(msg.senderId);
+    if (!peer)
+        return;
+#if LORA_SESSION_RESUMPTION
+    if (verifyAuthResponse(peer, msg.payload, msg.messageCount, id))
+        saveSessionTicket(peer, seed);
+#else
+    verifyAuthResponse(peer, msg.payload, msg.messageCount, id);
+#endif
+}
+
+/**
+ * TX: answers the RX's public key with ours plus an immediate ACK,
+ * then derives the shared session key.
+ */
+void handleTxPkExchange(const LoRaMessage &msg)
+{
+    NodeState *peer = findOrCreatePeer(msg.senderId);
+    if (!peer)
+        return;
+
+    if (msg.receiverId == "ALL")
+    {
+        // Broadcast announcement: answer until the announcer has our PK (it ACKs and moves on)
+        bool sameKey = remotePublicKeyMatches(peer, msg.payload);
+        if (sameKey && peer->state != PeerState::IDLE && peer->state != PeerState::ACK_PENDING)
+            return;
+        if (!sameKey && hasRemotePublicKey(peer))
+            resetPeer(peer); // Announcer restarted with a new key
+    }
+    else if (isPeerDHComplete(peer))
+    {
+        return;
+    }
+
+    if (!storeRemotePublicKey(peer, msg.payload))
+    {
+        Serial.println("⚠️  Malformed PK from " + msg.senderId + ". Ignoring.");
+        return;
+    }
+    peer->pkReceived = true;
+
+    createLocalKeys(peer, seed);
+
+    String pkMsg = createMessage("PK", id, msg.senderId, publicKeyPayload(peer));
+    sendMessage("PK", id, msg.senderId, publicKeyPayload(peer));
+
+    Serial.println(" \n======== STEP 4: Tx -> Rx :DH Key Exchange ========");
+    Serial.println("PUBLIC KEY: " + publicKeyPayload(peer));
+    Serial.println("[ " + pkMsg + " ] ");
+    Serial.println("=====================================================");
+
+    peer->pkSent = true;
+    peer->state = PeerState::ACK_PENDING;
+
+    // Send ACK immediately
+    String ackMsg = createMessage("ACK", id, msg.senderId, "OK");
+    sendMessage("ACK", id, msg.senderId, "OK");
+
+    Serial.println(" \n======== Tx -> Rx :Sends Acknowledgement ========");
+    Serial.println("[ " + ackMsg + " ] ");
+    Serial.println("=====================================================");
+
+    // Derive shared session key
+    if (peer->sharedSessionKey == 0 &&
+        peer->pkReceived && peer->pkSent &&
+        deriveSessionKey(peer, id))
+    {
+        Serial.println(" \n\n======== STEP 6: Tx Generates Shared Session Key ========");
+        Serial.println("SHARED SESSION KEY: " + sessionKeyString(peer));
+        Serial.println("==========================================================");
+    }
+
+    markPeerAckReceived(peer);
+}
+
+/**
+ * TX: handles ACK from the RX and promotes the peer to SECURE_COMM once DH is complete.
+ */
+void handleTxAck(const LoRaMessage &msg)
+{
+    NodeState *peer = findOrCreatePeer(msg.senderId);
+    if (!peer)
+        return;
+    bool wasAckMissing = !peer->ackReceived;
+    markPeerAckReceived(peer);
+
+    if (peer->pkReceived && peer->state == PeerState::ACK_PENDING && wasAckMissing)
+    {
+        sendMessage("ACK", id, msg.senderId, "OK");
+    }
+
+    if (peer->sharedSessionKey == 0 && peer->pkSent && peer->pkReceived)
+    {
+        deriveSessionKey(peer, id);
+    }
+
+    if (isPeerDHComplete(peer) && peer->state != PeerState::SECURE_COMM)
+    {
+        peer->state = PeerState::SECURE_COMM;
+        printPeerStatus();
+    }
+}
+
+/**
+ * TX: handles a CLEAR request, logging the full frame.
+ */
+void handleTxClear(const LoRaMessage &msg)
+{
+    if (msg.receiverId == "ALL" || msg.receiverId == id)
+    {
+        Serial.println("STEP 2: ⚠️  Received CLEAR from " + msg.senderId + ". Removing peer.");
+        Serial.println("[ " +
+                       msg.type + ":" +
+                       msg.senderId + ":" +
+                       msg.receiverId + ":" +
+                       msg.payload +
+                       " ] \n");
+
+        peers.remove(peers.find(msg.senderId));
+#if LORA_SESSION_RESUMPTION
+        eraseSessionTicket(msg.senderId);
+#endif
+    }
+}
+
+/**
+ * TX: answers the RX's challenge.
+ */
+void handleTxChal(const LoRaMessage &msg)
+{
+    NodeState *peer = findOrCreatePeer(msg.senderId);
+    if (!peer)
+        return;
+    handleChallengeResponse(peer, msg, id, ttl);
+}
+
+/**
+ * TX: marks the peer AUTHENTICATED once the RX confirms our response.
+ */
+void handleAuthSuccess(const LoRaMessage &msg)
+{
+    NodeState *peer = findOrCreatePeer(msg.senderId);
+    if (!peer)
+        return;
+    if (msg.payload == "OK")
+    {
+        Serial.println("✅ Received AUTH success from " + msg.senderId);
+        peer->state = PeerState::AUTHENTICATED;
+#if LORA_SESSION_RESUMPTION
+        saveSessionTicket(peer, seed);
+#endif
+    }
+}
+
+/**
+ * Answers a peer's RESUME (it rebooted and restored its session ticket).
+ */
+void handleResume(const LoRaMessage &msg)
+{
+    if (msg.receiverId != id)
+        return;
+
+#if LORA_SESSION_RESUMPTION
+    NodeState *peer = findOrCreatePeer(msg.senderId);
+    if (!peer)
+        return;
+    handleResumeRequest(peer, msg, id, ttl, seed);
+#else
+    // Resumption is disabled here: make the peer run the full handshake
+    sendMessage("CLEAR", id, msg.senderId, "RESET");
+#endif
+}
+
+/**
+ * Completes our own RESUME after a reboot.
+ */
+void handleResumed(const LoRaMessage &msg)
+{
+    if (msg.receiverId != id)
+        return;
+
+#if LORA_SESSION_RESUMPTION
+    NodeState *peer = findOrCreatePeer(msg.senderId);
+    if (!peer)
+        return;
+    verifyResumeResponse(peer, msg, id, seed);
+#endif
+}
+
+/**
+ * Responder side of the 1-RTT handshake (answered in every build).
+ */
+void handleKxInit(const LoRaMessage &msg)
+{
+    if (msg.receiverId != id)
+        return;
+
+    NodeState *peer = findOrCreatePeer(msg.senderId);
+    if (!peer)
+        return;
+#if LORA_SESSION_RESUMPTION
+    if (answerFastHandshake(peer, msg, id, seed))
+        saveSessionTicket(peer, seed);
+#else
+    answerFastHandshake(peer, msg, id, seed);
+#endif
+}
+
+/**
+ * Initiator side of the 1-RTT handshake: checks the responder's key confirmation.
+ */
+void handleKxConfirm(const LoRaMessage &msg)
+{
+    if (msg.receiverId != id)
+        return;
+
+    NodeState *peer = findOrCreatePeer(msg.senderId);
+    if (!peer)
+        return;
+#if LORA_SESSION_RESUMPTION
+    if (completeFastHandshake(peer, msg, id))
+        saveSessionTicket(peer, seed);
+#else
+    completeFastHandshake(peer, msg, id);
+#endif
+}
+
+/**
+ * RX: resends unanswered KX_INITs and falls back to the PK exchange after the last attempt.
+ */
+void retryFastHandshakes()
+{
+    unsigned long now = millis();
+
+    for (auto &peer : peers)
+    {
+        if (peer.state != PeerState::KX_SENT || now - peer.handshakeSentAt < FAST_HANDSHAKE_TIMEOUT)
+            continue;
+
+        if (peer.handshakeAttempts < FAST_HANDSHAKE_ATTEMPTS)
+        {
+            startFastHandshake(&peer, id, seed);
+        }
+        else
+        {
+            Serial.println("⌛ No KX_CONFIRM from " + peerId(&peer) + ". Falling back to PK exchange.");
+            peer.state = PeerState::IDLE;
+            startKeyExchange(&peer);
+        }
+    }
+}
+
+// ========== Handler tables (index = MessageType) ==========
+
+const MessageHandler rxMessageHandlers[MESSAGE_TYPE_COUNT] = {
+    nullptr,          // INVALID
+    handlePing,       // PING
+    handlePong,       // PONG
+    handlePkExchange, // PK
+    handleAck,        // ACK
+    handleClear,      // CLEAR
+    handleChal,       // CHAL
+    handleResp,       // RESP
+    handleMsg,        // MSG
+    nullptr,          // AUTH_SUCCESS
+    handleResume,     // RESUME
+    handleResumed,    // RESUMED
+    handleKxInit,     // KX_INIT
+    handleKxConfirm,  // KX_CONFIRM
+};
+
+const MessageHandler txMessageHandlers[MESSAGE_TYPE_COUNT] = {
+    nullptr,            // INVALID
+    handlePing,         // PING
+    nullptr,            // PONG
+    handleTxPkExchange, // PK
+    handleTxAck,        // ACK
+    handleTxClear,      // CLEAR
+    handleTxChal,       // CHAL
+    nullptr,            // RESP
+    nullptr,            // MSG
+    handleAuthSuccess,  // AUTH_SUCCESS
+    handleResume,       // RESUME
+    handleResumed,      // RESUMED
+    handleKxInit,       // KX_INIT
+    handleKxConfirm,    // KX_CONFIRM
+};
+
+bool dispatchMessage(const LoRaMessageView &view, const MessageHandler handlers[MESSAGE_TYPE_COUNT])
+{
+    MessageHandler handler = handlers[(uint8_t)view.messageType];
+    if (handler == nullptr)
+        return false;
+
+    // Our own frames come back to us through relays
+    if (view.sender != NODE_ADDR_INVALID && view.sender == encodeNodeAddress(id))
+        return false;
+
+    handler(toMessage(view));
+    return true;
 }
@@ -5,19 +5,61 @@
 #include <LoRa.h>
 #include "DHExchange.h"
 #include "MessageUtils.h"
+#include "MessageTransport.h"
+#include "MessageType.h"
+#include "MessageView.h"
 #include "NodeManager.h"
+#include "PeerKeys.h"
 #include "EncryptionUtils.h"
 #include "ChallengeAuth.h"
+#include "SessionResume.h"
+#include "FastHandshake.h"
+#include "SessionTicket.h"
 
-// These are declared in main RX node file
+// These are declared in the main node file (RX or TX)
 extern String id;
 extern uint32_t ttl;
+extern uint32_t seed;
 
-// Handles individual message types
+// Handles individual message types (shared / RX role)
 void handlePing(const LoRaMessage &msg);
-void handlePkExchange(const LoRaMessage &msg, uint32_t seed);
+void handlePkExchange(const LoRaMessage &msg);
 void handleAck(const LoRaMessage &msg);
 void handleClear(const LoRaMessage &msg);
 void handleMsg(const LoRaMessage &msg);
+void handlePong(const LoRaMessage &msg);
+void handleChal(const LoRaMessage &msg);
+void handleResp(const LoRaMessage &msg);
+void announcePublicKey();
+
+// Session resumption (both roles)
+void handleResume(const LoRaMessage &msg);
+void handleResumed(const LoRaMessage &msg);
+
+// 1-RTT handshake (both roles answer; the RX initiates with LORA_FAST_HANDSHAKE)
+void handleKxInit(const LoRaMessage &msg);
+void handleKxConfirm(const LoRaMessage &msg);
+void retryFastHandshakes();
+
+// TX role
+void handleTxPkExchange(const LoRaMessage &msg);
+void handleTxAck(const LoRaMessage &msg);
+void handleTxClear(const LoRaMessage &msg);
+void handleTxChal(const LoRaMessage &msg);
+void handleAuthSuccess(const LoRaMessage &msg);
+
+// ========== Table-driven dispatch ==========
+// Handler tables are indexed by MessageType; nullptr means the role ignores that type.
+typedef void (*MessageHandler)(const LoRaMessage &msg);
+
+extern const MessageHandler rxMessageHandlers[MESSAGE_TYPE_COUNT];
+extern const MessageHandler txMessageHandlers[MESSAGE_TYPE_COUNT];
+
+/**
+ * Looks up the handler for the view's type and runs it on a materialised LoRaMessage.
+ * Unknown or ignored types are rejected after a single table lookup, without allocating.
+ * Returns true if a handler ran.
+ */
+bool dispatchMessage(const LoRaMessageView &view, const MessageHandler handlers[MESSAGE_TYPE_COUNT]);
 
 #endif
@@ -0,0 +1,44 @@
+#include "AggregateFrame.h"
+
+size_t beginAggregateFrame(uint8_t *out, size_t capacity)
+{
+    if (capacity < AGGREGATE_FRAME_HEADER_LEN)
+        return 0;
+
+    out[0] = AGGREGATE_FRAME_MAGIC;
+    return AGGREGATE_FRAME_HEADER_LEN;
+}
+
+size_t appendAggregateFrame(uint8_t *out, size_t length, size_t capacity, const uint8_t *frame, size_t frameLength)
+{
+    if (frameLength == 0 || frameLength > 0xFF || length + AGGREGATE_FRAME_OVERHEAD + frameLength > capacity)
+        return 0;
+
+    out[length] = (uint8_t)frameLength;
+    memcpy(out + length + AGGREGATE_FRAME_OVERHEAD, frame, frameLength);
+    return length + AGGREGATE_FRAME_OVERHEAD + frameLength;
+}
+
+uint8_t forEachFrame(const uint8_t *buffer, size_t length, FrameHandler handle)
+{
+    if (!isAggregateFrame(buffer, length))
+    {
+        handle(buffer, length);
+        return 1;
+    }
+
+    uint8_t handled = 0;
+    size_t offset = AGGREGATE_FRAME_HEADER_LEN;
+    while (offset + AGGREGATE_FRAME_OVERHEAD < length)
+    {
+        size_t frameLength = buffer[offset];
+        offset += AGGREGATE_FRAME_OVERHEAD;
+        if (frameLength == 0 || offset + frameLength > length)
+            break;
+
+        handle(buffer + offset, frameLength);
+        offset += frameLength;
+        handled++;
+    }
+    return handled;
+}
@@ -0,0 +1,48 @@
+#ifndef AGGREGATE_FRAME_H
+#define AGGREGATE_FRAME_H
+
+#include <Arduino.h>
+#include "LoRaConfig.h"
+
+/*
+ * Aggregate frame: several complete frames (ASCII or binary) sent as one LoRa packet by a
+ * relay, so they share one preamble and PHY header.
+ *
+ *   byte 0: AGGREGATE_FRAME_MAGIC
+ *   then per packed frame: 1 length byte, the frame exactly as it would be sent alone
+ *
+ * Neither an ASCII type name nor a binary header starts with the magic byte, so receivers
+ * tell the formats apart from the first byte. Every node unpacks aggregates; only relays
+ * built with LORA_RELAY_AGGREGATION create them.
+ */
+
+#define AGGREGATE_FRAME_MAGIC 0xA1
+#define AGGREGATE_FRAME_HEADER_LEN 1
+#define AGGREGATE_FRAME_OVERHEAD 1 // Length byte per packed frame
+
+typedef void (*FrameHandler)(const uint8_t *frame, size_t length);
+
+inline bool isAggregateFrame(const uint8_t *buffer, size_t length)
+{
+    return length > AGGREGATE_FRAME_HEADER_LEN && buffer[0] == AGGREGATE_FRAME_MAGIC;
+}
+
+/**
+ * Starts an empty aggregate in `out`. Returns its length, or 0 if `capacity` is too small.
+ */
+size_t beginAggregateFrame(uint8_t *out, size_t capacity);
+
+/**
+ * Appends a frame to the aggregate of `length` bytes in `out`.
+ * Returns the new length, or 0 if the frame does not fit (the aggregate is left unchanged).
+ */
+size_t appendAggregateFrame(uint8_t *out, size_t length, size_t capacity, const uint8_t *frame, size_t frameLength);
+
+/**
+ * Calls `handle` for each frame packed in an aggregate, or once for any other frame.
+ * A truncated aggregate is handled up to its last complete frame. Returns the number of
+ * frames handled.
+ */
+uint8_t forEachFrame(const uint8_t *buffer, size_t length, FrameHandler handle);
+
+#endif
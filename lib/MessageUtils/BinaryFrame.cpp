@@ -0,0 +1,137 @@
+#include "BinaryFrame.h"
+
+// Role prefixes, index = 2-bit role code (0 is reserved)
+static const char *const nodeRolePrefixes[] = {"", "TX", "RX", "RL"};
+
+#define NODE_ADDR_MAX_NUMBER 0x3FFE // 0x3FFF under role RL would collide with NODE_ADDR_BROADCAST
+
+uint16_t encodeNodeAddress(const char *id, size_t length)
+{
+    if (length == 3 && memcmp(id, "ALL", 3) == 0)
+        return NODE_ADDR_BROADCAST;
+
+    if (length < 3 || length > 7)
+        return NODE_ADDR_INVALID;
+
+    uint16_t role = 0;
+    for (uint8_t r = 1; r < 4; r++)
+    {
+        if (id[0] == nodeRolePrefixes[r][0] && id[1] == nodeRolePrefixes[r][1])
+        {
+            role = r;
+            break;
+        }
+    }
+    if (role == 0)
+        return NODE_ADDR_INVALID;
+
+    if (length > 3 && id[2] == '0') // Leading zeros would not survive decodeNodeAddress
+        return NODE_ADDR_INVALID;
+
+    uint32_t number = 0;
+    for (size_t i = 2; i < length; i++)
+    {
+        if (id[i] < '0' || id[i] > '9')
+            return NODE_ADDR_INVALID;
+        number = number * 10 + (id[i] - '0');
+    }
+    if (number > NODE_ADDR_MAX_NUMBER)
+        return NODE_ADDR_INVALID;
+
+    uint16_t address = (role << 14) | (uint16_t)number;
+    return address == NODE_ADDR_BROADCAST ? NODE_ADDR_INVALID : address; // "RL16383"
+}
+
+uint16_t encodeNodeAddress(const String &id)
+{
+    return encodeNodeAddress(id.c_str(), id.length());
+}
+
+String decodeNodeAddress(uint16_t address)
+{
+    if (address == NODE_ADDR_BROADCAST)
+        return "ALL";
+
+    uint8_t role = address >> 14;
+    if (role == 0)
+        return "INVALID_ID";
+
+    return String(nodeRolePrefixes[role]) + String(address & 0x3FFF);
+}
+
+size_t formatNodeAddress(uint16_t address, char *out, size_t capacity)
+{
+    int written = address == NODE_ADDR_BROADCAST
+                      ? snprintf(out, capacity, "ALL")
+                      : snprintf(out, capacity, "%s%u", nodeRolePrefixes[address >> 14], address & 0x3FFF);
+
+    return (address >> 14) == 0 || written < 0 || (size_t)written >= capacity ? 0 : written;
+}
+
+size_t encodeBinaryFrame(MessageType type, const String &senderId, const String &receiverId,
+                         int ttl, uint32_t messageCount,
+                         const uint8_t *payload, size_t payloadLength, bool packedPayload,
+                         uint8_t *out, size_t capacity, const FrameRoute *route)
+{
+    uint8_t code = (uint8_t)type;
+    uint16_t sender = encodeNodeAddress(senderId);
+    uint16_t receiver = encodeNodeAddress(receiverId);
+
+    if (type == MessageType::INVALID || sender == NODE_ADDR_INVALID || receiver == NODE_ADDR_INVALID)
+        return 0;
+    if (ttl < 0 || ttl > BINARY_MAX_TTL || messageCount > BINARY_COUNTER_MASK)
+        return 0;
+    size_t headerLength = BINARY_FRAME_HEADER_LEN + (route ? BINARY_ROUTE_LEN : 0);
+    if (payloadLength > BINARY_FRAME_MAX_PAYLOAD || headerLength + payloadLength > capacity)
+        return 0;
+
+    uint32_t ttlAndCount = ((uint32_t)ttl << 28) | messageCount;
+
+    out[0] = BINARY_FRAME_MAGIC | BINARY_FRAME_VERSION;
+    out[1] = (packedPayload ? BINARY_FLAG_PACKED_PAYLOAD : 0) | (route ? BINARY_FLAG_ROUTED : 0) | code;
+    out[2] = sender >> 8;
+    out[3] = sender & 0xFF;
+    out[4] = receiver >> 8;
+    out[5] = receiver & 0xFF;
+    out[6] = ttlAndCount >> 24;
+    out[7] = (ttlAndCount >> 16) & 0xFF;
+    out[8] = (ttlAndCount >> 8) & 0xFF;
+    out[9] = ttlAndCount & 0xFF;
+    out[10] = (uint8_t)payloadLength;
+    if (route)
+    {
+        out[11] = route->hop >> 8;
+        out[12] = route->hop & 0xFF;
+        out[13] = route->via >> 8;
+        out[14] = route->via & 0xFF;
+    }
+    memcpy(out + headerLength, payload, payloadLength);
+
+    return headerLength + payloadLength;
+}
+
+size_t rewriteBinaryRelayFields(uint8_t *frame, size_t length, size_t capacity, int ttl, const FrameRoute *route)
+{
+    if (ttl < 0 || ttl > BINARY_MAX_TTL || length < BINARY_FRAME_HEADER_LEN)
+        return 0;
+
+    frame[6] = (frame[6] & 0x0F) | (ttl << 4);
+    if (!route)
+        return length;
+
+    if (!(frame[1] & BINARY_FLAG_ROUTED))
+    {
+        if (length + BINARY_ROUTE_LEN > capacity)
+            return 0;
+        memmove(frame + BINARY_FRAME_HEADER_LEN + BINARY_ROUTE_LEN, frame + BINARY_FRAME_HEADER_LEN,
+                length - BINARY_FRAME_HEADER_LEN);
+        frame[1] |= BINARY_FLAG_ROUTED;
+        length += BINARY_ROUTE_LEN;
+    }
+
+    frame[11] = route->hop >> 8;
+    frame[12] = route->hop & 0xFF;
+    frame[13] = route->via >> 8;
+    frame[14] = route->via & 0xFF;
+    return length;
+}
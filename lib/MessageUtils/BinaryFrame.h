@@ -0,0 +1,96 @@
+// BinaryFrame.h
+#ifndef BINARY_FRAME_H
+#define BINARY_FRAME_H
+
+#include <Arduino.h>
+#include "MessageUtils.h"
+#include "MessageType.h"
+
+/**
+ * Compact binary wire format (version 1).
+ *
+ *   byte  0     : 0xB0 | version          (top bit set, never a printable ASCII type)
+ *   byte  1     : flags (upper 3 bits) | MessageType (lower 5 bits)
+ *   bytes 2..3  : sender address   (big-endian, see encodeNodeAddress)
+ *   bytes 4..5  : receiver address (big-endian, 0xFFFF = ALL)
+ *   bytes 6..9  : TTL (upper 4 bits) | messageCount (lower 28 bits), big-endian
+ *   byte  10    : payload length
+ *   bytes 11..14: only with BINARY_FLAG_ROUTED: hop address, via address (see FrameRoute)
+ *   bytes 11..  : raw payload (15.. when routed)
+ *
+ * Encrypted payloads (CHAL, RESP, MSG) are carried as raw ciphertext instead
+ * of base64 text and flagged with BINARY_FLAG_PACKED_PAYLOAD.
+ */
+
+#define BINARY_FRAME_MAGIC 0xB0
+#define BINARY_FRAME_VERSION 1
+#define BINARY_FRAME_HEADER_LEN 11
+#define BINARY_FRAME_MAX_PAYLOAD 240
+#define BINARY_FRAME_MAX_LEN (BINARY_FRAME_HEADER_LEN + BINARY_FRAME_MAX_PAYLOAD)
+
+#define BINARY_FLAG_PACKED_PAYLOAD 0x80 // Payload is raw bytes that travel as base64 in ASCII frames
+#define BINARY_FLAG_ROUTED 0x40         // Header carries hop/via addresses (LORA_ROUTING)
+#define BINARY_TYPE_MASK 0x1F
+#define BINARY_ROUTE_LEN 4
+
+#define BINARY_MAX_TTL 0x0F
+#define BINARY_COUNTER_MASK 0x0FFFFFFFUL
+
+// Compact node addresses: 2-bit role (TX/RX/RL) + 14-bit device number
+#define NODE_ADDR_INVALID 0x0000
+#define NODE_ADDR_BROADCAST 0xFFFF
+
+/**
+ * Packs a device ID such as "TX101" or "RX1101" into a 16-bit address.
+ * "ALL" maps to NODE_ADDR_BROADCAST; anything else returns NODE_ADDR_INVALID, including
+ * numbers with leading zeros, so every valid address decodes back to the same ID.
+ */
+uint16_t encodeNodeAddress(const char *id, size_t length);
+uint16_t encodeNodeAddress(const String &id);
+
+/**
+ * Expands a 16-bit address back into its textual device ID.
+ */
+String decodeNodeAddress(uint16_t address);
+
+/**
+ * Writes the textual device ID of `address` into `out` without allocating.
+ * Returns its length, or 0 if it does not fit in `capacity` (including the terminator).
+ */
+size_t formatNodeAddress(uint16_t address, char *out, size_t capacity);
+
+/**
+ * Per-hop routing fields of a relayed frame (LORA_ROUTING, see RouteTable.h).
+ * Rewritten at every hop and, like the TTL, not covered by the AEAD tag.
+ */
+struct FrameRoute
+{
+    uint16_t hop; // Node that transmitted this copy
+    uint16_t via; // Relay that should forward it next; NODE_ADDR_BROADCAST = flood
+};
+
+/**
+ * Returns true if the buffer starts with a binary frame header.
+ */
+inline bool isBinaryFrame(const uint8_t *buffer, size_t length)
+{
+    return length >= BINARY_FRAME_HEADER_LEN && (buffer[0] & 0xF0) == BINARY_FRAME_MAGIC;
+}
+
+/**
+ * Writes a binary frame into `out`, with routing fields if `route` is given.
+ * Returns the number of bytes written, or 0 if a field does not fit the format.
+ */
+size_t encodeBinaryFrame(MessageType type, const String &senderId, const String &receiverId,
+                         int ttl, uint32_t messageCount,
+                         const uint8_t *payload, size_t payloadLength, bool packedPayload,
+                         uint8_t *out, size_t capacity, const FrameRoute *route = nullptr);
+
+/**
+ * Rewrites the TTL (and, if `route` is given, the routing fields) of a parsed binary frame
+ * in place, inserting the routing fields if the frame has none. The payload is not touched.
+ * Returns the new frame length, or 0 if the TTL is out of range or the frame would exceed `capacity`.
+ */
+size_t rewriteBinaryRelayFields(uint8_t *frame, size_t length, size_t capacity, int ttl, const FrameRoute *route);
+
+#endif
@@ -0,0 +1,251 @@
+#include "MessageTransport.h"
+#include <LoRa.h>
+#include "Airtime.h"
+#include "EncryptionUtils.h"
+#include "SecureRandom.h"
+#include "LoRaReceive.h"
+#if LORA_ROUTING
+#include "RouteTable.h"
+#endif
+
+// Payloads that are base64 in ASCII frames and travel raw in binary frames
+static bool hasPackedPayload(MessageType type)
+{
+    return isSequencedMessageType(type) || (LORA_X25519 && (type == MessageType::PK || type == MessageType::KX_INIT));
+}
+
+size_t encodeFrame(const String &type, const String &senderId, const String &receiverId,
+                   int ttl, uint32_t messageCount, const String &payload, bool withTTL,
+                   uint8_t *out, size_t capacity, const FrameRoute *route)
+{
+#if LORA_BINARY_FRAMES
+    (void)withTTL;
+    MessageType messageType = messageTypeFromName(type);
+
+    if (hasPackedPayload(messageType))
+    {
+        uint8_t raw[BINARY_FRAME_MAX_PAYLOAD];
+        size_t rawLength = 0;
+
+        // Strip the base64 armour: ciphertext and X25519 keys travel as raw bytes
+        if (payload.length() > (BINARY_FRAME_MAX_PAYLOAD / 3) * 4)
+            return 0;
+        if (payload.length() > 0 && !base64Decode(payload, raw, &rawLength))
+            return 0;
+
+        return encodeBinaryFrame(messageType, senderId, receiverId, ttl, messageCount,
+                                 raw, rawLength, true, out, capacity, route);
+    }
+
+    return encodeBinaryFrame(messageType, senderId, receiverId, ttl, messageCount,
+                             (const uint8_t *)payload.c_str(), payload.length(), false, out, capacity, route);
+#else
+    String frame;
+    if (withTTL && route)
+        frame = createRoutedMessage(type, senderId, receiverId, ttl, decodeNodeAddress(route->hop),
+                                    decodeNodeAddress(route->via), messageCount, payload);
+    else
+        frame = withTTL ? createMessageWithTTL(type, senderId, receiverId, ttl, messageCount, payload)
+                        : createMessage(type, senderId, receiverId, payload);
+
+    if (frame.length() > capacity)
+        return 0;
+
+    memcpy(out, frame.c_str(), frame.length());
+    return frame.length();
+#endif
+}
+
+// The TTL field of an ASCII frame is the fourth ':'-separated field
+static size_t rewriteAsciiRelayFields(uint8_t *frame, size_t length, size_t capacity, int ttl, const FrameRoute *route)
+{
+    size_t start = 0;
+    uint8_t colons = 0;
+    for (; start < length && colons < 3; start++)
+    {
+        if (frame[start] == ':')
+            colons++;
+    }
+
+    uint8_t *colon = colons == 3 ? (uint8_t *)memchr(frame + start, ':', length - start) : nullptr;
+    if (!colon)
+        return 0;
+
+    // Without a route only the TTL digits change and an existing "/hop/via" suffix is kept
+    size_t end = colon - frame;
+    if (!route)
+    {
+        uint8_t *slash = (uint8_t *)memchr(frame + start, '/', end - start);
+        if (slash)
+            end = slash - frame;
+    }
+
+    char field[24];
+    int fieldLength = snprintf(field, sizeof(field), "%d", ttl);
+    if (route)
+    {
+        char hop[8], via[8];
+        if (!formatNodeAddress(route->hop, hop, sizeof(hop)) || !formatNodeAddress(route->via, via, sizeof(via)))
+            return 0;
+        fieldLength = snprintf(field, sizeof(field), "%d/%s/%s", ttl, hop, via);
+    }
+    if (fieldLength <= 0 || (size_t)fieldLength >= sizeof(field))
+        return 0;
+
+    size_t newLength = length - (end - start) + fieldLength;
+    if (newLength > capacity)
+        return 0;
+
+    memmove(frame + start + fieldLength, frame + end, length - end);
+    memcpy(frame + start, field, fieldLength);
+    return newLength;
+}
+
+size_t rewriteRelayFields(uint8_t *frame, size_t length, size_t capacity, int ttl, const FrameRoute *route)
+{
+    if (isBinaryFrame(frame, length))
+        return rewriteBinaryRelayFields(frame, length, capacity, ttl, route);
+
+    return rewriteAsciiRelayFields(frame, length, capacity, ttl, route);
+}
+
+LoRaMessage decodeFrame(const uint8_t *buffer, size_t length)
+{
+    LoRaMessageView view;
+    parseMessageView(buffer, length, view);
+    return toMessage(view);
+}
+
+void sendFrame(const uint8_t *frame, size_t length)
+{
+#if LORA_RX_INTERRUPT
+    stopFrameReceiver();
+#endif
+    LoRa.beginPacket();
+    LoRa.write(frame, length);
+    LoRa.endPacket();
+#if LORA_RX_INTERRUPT
+    startFrameReceiver(); // endPacket leaves the radio in standby
+#endif
+}
+
+#if LORA_CONTROL_TTL
+static_assert(LORA_CONTROL_TTL <= BINARY_MAX_TTL, "LORA_CONTROL_TTL must fit the binary TTL field (0..15)");
+
+// Control frames are numbered per node rather than per link. A random start keeps a
+// rebooted node's frames from matching relay duplicate caches.
+static uint32_t nextControlSequence()
+{
+    static uint32_t sequence = secureRandomRange(0, BINARY_COUNTER_MASK);
+    sequence = (sequence + 1) & BINARY_COUNTER_MASK;
+    return sequence;
+}
+#endif
+
+void sendMessage(const String &type, const String &senderId, const String &receiverId, const String &payload)
+{
+#if LORA_CONTROL_TTL
+    sendMessageWithTTL(type, senderId, receiverId, LORA_CONTROL_TTL, nextControlSequence(), payload);
+#else
+    uint8_t frame[LORA_MAX_FRAME_LEN];
+    size_t length = encodeFrame(type, senderId, receiverId, 0, 0, payload, false, frame, sizeof(frame));
+
+    if (length == 0)
+    {
+        Serial.println("⚠️  Could not encode " + type + " frame for " + receiverId);
+        return;
+    }
+    sendFrame(frame, length);
+#endif
+}
+
+void sendMessageWithTTL(const String &type, const String &senderId, const String &receiverId,
+                        int ttl, uint32_t messageCount, const String &payload)
+{
+    uint8_t frame[LORA_MAX_FRAME_LEN];
+#if LORA_ROUTING
+    FrameRoute route = outgoingRoute(encodeNodeAddress(receiverId), millis());
+    size_t length = encodeFrame(type, senderId, receiverId, ttl, messageCount, payload, true, frame, sizeof(frame), &route);
+#else
+    size_t length = encodeFrame(type, senderId, receiverId, ttl, messageCount, payload, true, frame, sizeof(frame));
+#endif
+
+    if (length == 0)
+    {
+        Serial.println("⚠️  Could not encode " + type + " frame for " + receiverId);
+        return;
+    }
+    sendFrame(frame, length);
+}
+
+// Size of the binary encoding of the same message, independent of LORA_BINARY_FRAMES
+static size_t binaryFrameLength(const String &type, const String &payload)
+{
+    if (hasPackedPayload(messageTypeFromName(type)))
+        return BINARY_FRAME_HEADER_LEN + (payload.length() / 4) * 3 -
+               (payload.endsWith("==") ? 2 : payload.endsWith("=") ? 1 : 0);
+
+    return BINARY_FRAME_HEADER_LEN + payload.length();
+}
+
+static void printAirtimeRow(const String &type, size_t asciiLength, size_t binaryLength)
+{
+    Serial.print(type);
+    Serial.print("\tASCII ");
+    Serial.print(asciiLength);
+    Serial.print(" B ");
+    Serial.print(loraTimeOnAirMicros(asciiLength) / 1000.0f, 1);
+    Serial.print(" ms (SF12 ");
+    Serial.print(loraTimeOnAirMicros(asciiLength, 12) / 1000.0f, 1);
+    Serial.print(" ms) | BINARY ");
+    Serial.print(binaryLength);
+    Serial.print(" B ");
+    Serial.print(loraTimeOnAirMicros(binaryLength) / 1000.0f, 1);
+    Serial.print(" ms (SF12 ");
+    Serial.print(loraTimeOnAirMicros(binaryLength, 12) / 1000.0f, 1);
+    Serial.println(" ms)");
+}
+
+void printAirtimeComparison(const String &selfId, const String &peerId, uint32_t ttl)
+{
+    // Representative payloads: a DH public key, a 6-digit challenge,
+    // a 10-digit response and a 10-bit analogRead() sample
+    uint8_t demoKey[SESSION_KEY_SIZE];
+    memset(demoKey, 0x5A, sizeof(demoKey));
+    const uint32_t demoCount = 42;
+
+    const char *types[] = {"PING", "PONG", "PK", "ACK", "CHAL", "RESP", "MSG"};
+    String payloads[] = {
+        "Who is out there?",
+        "READY",
+#if LORA_X25519
+        base64Encode(demoKey, sizeof(demoKey)),
+#else
+        String(2147483646UL),
+#endif
+        "OK",
+        encryptPayload(String(999999), demoKey, demoCount, createAssociatedData("CHAL", selfId, peerId, demoCount)),
+        encryptPayload(String(4294967295UL), demoKey, demoCount, createAssociatedData("RESP", selfId, peerId, demoCount)),
+        encryptPayload(String(1023), demoKey, demoCount, createAssociatedData("MSG", selfId, peerId, demoCount))};
+
+    Serial.println("\n========= Time on Air (SF" + String(LORA_SPREADING_FACTOR) + ", BW " +
+                   String((long)(LORA_SIGNAL_BANDWIDTH / 1000)) + " kHz) =========");
+
+    uint32_t asciiTotal = 0, binaryTotal = 0;
+    for (uint8_t i = 0; i < sizeof(types) / sizeof(types[0]); i++)
+    {
+        String type = types[i];
+        String ascii = hasTtlLayout(messageTypeFromName(type))
+                           ? createMessageWithTTL(type, selfId, peerId, ttl, demoCount, payloads[i])
+                           : createMessage(type, selfId, peerId, payloads[i]);
+        size_t binaryLength = binaryFrameLength(type, payloads[i]);
+
+        printAirtimeRow(type, ascii.length(), binaryLength);
+        asciiTotal += loraTimeOnAirMicros(ascii.length());
+        binaryTotal += loraTimeOnAirMicros(binaryLength);
+    }
+
+    Serial.println("Handshake + 1 MSG: ASCII " + String(asciiTotal / 1000.0f, 1) +
+                   " ms, BINARY " + String(binaryTotal / 1000.0f, 1) + " ms");
+    Serial.println("===================================================\n");
+}
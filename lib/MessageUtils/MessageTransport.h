@@ -0,0 +1,62 @@
+// MessageTransport.h
+#ifndef MESSAGE_TRANSPORT_H
+#define MESSAGE_TRANSPORT_H
+
+#include <Arduino.h>
+#include "LoRaConfig.h"
+#include "MessageUtils.h"
+#include "BinaryFrame.h"
+#include "MessageType.h"
+#include "MessageView.h"
+
+/**
+ * Encodes a message in the wire format selected by LORA_BINARY_FRAMES.
+ * `withTTL` selects the 6-part ASCII layout; binary frames always carry TTL and count.
+ * `route` adds hop/via fields to a TTL frame (ASCII: "ttl/hop/via" in the TTL field).
+ * Returns the number of bytes written to `out`, or 0 if the message does not fit.
+ */
+size_t encodeFrame(const String &type, const String &senderId, const String &receiverId,
+                   int ttl, uint32_t messageCount, const String &payload, bool withTTL,
+                   uint8_t *out, size_t capacity, const FrameRoute *route = nullptr);
+
+/**
+ * Prepares a received TTL frame for forwarding by rewriting its TTL (and, if `route` is
+ * given, its hop/via fields) in place, in either wire format. Sender, counter and payload
+ * bytes stay as received, so nothing is parsed into Strings or re-encoded.
+ * Returns the new frame length, or 0 if the frame has no TTL field or would exceed `capacity`.
+ */
+size_t rewriteRelayFields(uint8_t *frame, size_t length, size_t capacity, int ttl, const FrameRoute *route = nullptr);
+
+/**
+ * Decodes a received frame, auto-detecting ASCII or binary encoding.
+ * Encrypted payloads and X25519 keys of binary frames are returned as base64 so handlers see the same
+ * LoRaMessage regardless of the wire format.
+ */
+LoRaMessage decodeFrame(const uint8_t *buffer, size_t length);
+
+/**
+ * Transmits an already encoded frame.
+ */
+void sendFrame(const uint8_t *frame, size_t length);
+
+/**
+ * Builds and transmits a basic 4-part message (type:sender:receiver:payload).
+ * With LORA_CONTROL_TTL it is sent with that TTL and the node's next control sequence
+ * number instead, so relays forward it.
+ */
+void sendMessage(const String &type, const String &senderId, const String &receiverId, const String &payload);
+
+/**
+ * Builds and transmits a 6-part message with TTL and message counter.
+ * With LORA_ROUTING the frame is addressed to the learned next hop towards receiverId.
+ */
+void sendMessageWithTTL(const String &type, const String &senderId, const String &receiverId,
+                        int ttl, uint32_t messageCount, const String &payload);
+
+/**
+ * Prints frame size and time-on-air of the handshake and data message mix
+ * in both wire formats at the configured and worst-case (SF12) spreading factor.
+ */
+void printAirtimeComparison(const String &selfId, const String &peerId, uint32_t ttl);
+
+#endif
@@ -0,0 +1,49 @@
+#include "MessageType.h"
+
+// Index = MessageType value
+static const char *const messageTypeNames[MESSAGE_TYPE_COUNT] = {
+    "INVALID", "PING", "PONG", "PK", "ACK", "CLEAR", "CHAL", "RESP", "MSG", "AUTH_SUCCESS",
+    "RESUME", "RESUMED", "KX_INIT", "KX_CONFIRM"};
+
+// `type` if `name` spells exactly its name, else INVALID
+static MessageType matchName(MessageType type, const char *name, size_t length)
+{
+    const char *candidate = messageTypeNames[(uint8_t)type];
+    return strlen(candidate) == length && memcmp(candidate, name, length) == 0 ? type : MessageType::INVALID;
+}
+
+MessageType messageTypeFromName(const char *name, size_t length)
+{
+    if (length == 0)
+        return MessageType::INVALID;
+
+    // The first byte (then the length or second byte) picks the only candidate, so an
+    // unknown type costs one compare and a known one a single memcmp
+    switch (name[0])
+    {
+    case 'A':
+        return matchName(length == 3 ? MessageType::ACK : MessageType::AUTH_SUCCESS, name, length);
+    case 'C':
+        return matchName(length == 4 ? MessageType::CHAL : MessageType::CLEAR, name, length);
+    case 'K':
+        return matchName(length == 7 ? MessageType::KX_INIT : MessageType::KX_CONFIRM, name, length);
+    case 'M':
+        return matchName(MessageType::MSG, name, length);
+    case 'P':
+        if (length == 2)
+            return matchName(MessageType::PK, name, length);
+        return matchName(name[1] == 'I' ? MessageType::PING : MessageType::PONG, name, length);
+    case 'R':
+        if (length == 4)
+            return matchName(MessageType::RESP, name, length);
+        return matchName(length == 6 ? MessageType::RESUME : MessageType::RESUMED, name, length);
+    default:
+        return MessageType::INVALID;
+    }
+}
+
+const char *messageTypeName(MessageType type)
+{
+    uint8_t code = (uint8_t)type;
+    return code < MESSAGE_TYPE_COUNT ? messageTypeNames[code] : messageTypeNames[0];
+}
@@ -0,0 +1,66 @@
+// MessageType.h
+#ifndef MESSAGE_TYPE_H
+#define MESSAGE_TYPE_H
+
+#include <Arduino.h>
+#include "LoRaConfig.h"
+
+/**
+ * Message types, decoded once per frame.
+ * The numeric value doubles as the binary wire code and as the index into handler tables.
+ */
+enum class MessageType : uint8_t
+{
+    INVALID = 0, // Unknown or malformed
+    PING,
+    PONG,
+    PK,
+    ACK,
+    CLEAR,
+    CHAL,
+    RESP,
+    MSG,
+    AUTH_SUCCESS,
+    RESUME,  // Session resumption request (see SessionResume.h)
+    RESUMED, // Session resumption answer
+    KX_INIT,   // 1-RTT handshake: initiator public key (see FastHandshake.h)
+    KX_CONFIRM // 1-RTT handshake: responder public key + transcript MAC
+};
+
+#define MESSAGE_TYPE_COUNT 14
+
+/**
+ * Maps a type name ("PING", "MSG", ...) to its MessageType (INVALID if unknown).
+ */
+MessageType messageTypeFromName(const char *name, size_t length);
+
+inline MessageType messageTypeFromName(const String &name)
+{
+    return messageTypeFromName(name.c_str(), name.length());
+}
+
+/**
+ * Returns the type name used on the ASCII wire, or "INVALID".
+ */
+const char *messageTypeName(MessageType type);
+
+/**
+ * Types sent with TTL and message count (CHAL, RESP, MSG, RESUME, RESUMED).
+ * Their payloads are stream-cipher output, base64 in ASCII frames and raw in binary frames.
+ */
+inline bool isSequencedMessageType(MessageType type)
+{
+    return type == MessageType::CHAL || type == MessageType::RESP || type == MessageType::MSG ||
+           type == MessageType::RESUME || type == MessageType::RESUMED;
+}
+
+/**
+ * Types sent in the 6-part ASCII layout (TTL and count): the sequenced types, or every
+ * type when LORA_CONTROL_TTL lets control frames travel through relays.
+ */
+inline bool hasTtlLayout(MessageType type)
+{
+    return LORA_CONTROL_TTL > 0 || isSequencedMessageType(type);
+}
+
+#endif
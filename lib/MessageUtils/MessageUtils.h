@@ -87,4 +87,24 @@ inline String createMessageWithTTL(const String &type, const String &senderId, c
     return type + ":" + senderId + ":" + receiverId + ":" + String(ttl) + ":" + String(messageCount) + ":" + payload;
 }
 
+/**
+ * Builds a 6-part message whose TTL field also names the transmitting node and the
+ * designated next relay ("ttl/hop/via", see FrameRoute).
+ */
+inline String createRoutedMessage(const String &type, const String &senderId, const String &receiverId, int ttl,
+                                  const String &hopId, const String &viaId, int messageCount, const String &payload)
+{
+    return type + ":" + senderId + ":" + receiverId + ":" + String(ttl) + "/" + hopId + "/" + viaId + ":" +
+           String(messageCount) + ":" + payload;
+}
+
+/**
+ * Builds the associated data that binds an encrypted payload to its frame header.
+ * TTL is left out because relays rewrite it in transit.
+ */
+inline String createAssociatedData(const String &type, const String &senderId, const String &receiverId, uint32_t messageCount)
+{
+    return type + ":" + senderId + ":" + receiverId + ":" + String(messageCount);
+}
+
 #endif
@@ -0,0 +1,178 @@
+#include "MessageView.h"
+#include "EncryptionUtils.h"
+
+String LoRaSlice::toString() const
+{
+    String s;
+    s.reserve(length);
+    for (uint8_t i = 0; i < length; i++)
+        s += data[i];
+    return s;
+}
+
+#define ASCII_TTL_LIMIT 0x7FFFUL          // Fits `int` on every target
+#define ASCII_COUNTER_LIMIT 0xFFFFFFFFUL // uint32_t messageCount
+
+// Same semantics as String::toInt() (optional sign, then leading digits), but returns false
+// instead of overflowing once the magnitude passes `limit`: the digits come off the air
+static bool parseSliceInt(const LoRaSlice &slice, uint32_t limit, int64_t &value)
+{
+    uint8_t i = 0;
+    bool negative = false;
+    if (i < slice.length && (slice.data[i] == '-' || slice.data[i] == '+'))
+        negative = slice.data[i++] == '-';
+
+    uint32_t magnitude = 0;
+    for (; i < slice.length && slice.data[i] >= '0' && slice.data[i] <= '9'; i++)
+    {
+        uint8_t digit = slice.data[i] - '0';
+        if (magnitude > (limit - digit) / 10)
+            return false;
+        magnitude = magnitude * 10 + digit;
+    }
+
+    value = negative ? -(int64_t)magnitude : (int64_t)magnitude;
+    return true;
+}
+
+// Optional "/<hop>/<via>" suffix of an ASCII TTL field
+static void parseSliceRoute(const LoRaSlice &slice, LoRaMessageView &view)
+{
+    const char *hop = (const char *)memchr(slice.data, '/', slice.length);
+    if (!hop)
+        return;
+    hop++;
+
+    const char *end = slice.data + slice.length;
+    const char *via = (const char *)memchr(hop, '/', end - hop);
+    if (!via)
+        return;
+
+    view.hop = encodeNodeAddress(hop, via - hop);
+    via++;
+    view.via = encodeNodeAddress(via, end - via);
+    if (view.via == NODE_ADDR_INVALID)
+        view.via = NODE_ADDR_BROADCAST;
+}
+
+static bool parseBinaryView(const uint8_t *buffer, size_t length, LoRaMessageView &view)
+{
+    if ((buffer[0] & 0x0F) != BINARY_FRAME_VERSION)
+        return false;
+
+    uint8_t code = buffer[1] & BINARY_TYPE_MASK;
+    uint8_t payloadLength = buffer[10];
+    if (code == 0 || code >= MESSAGE_TYPE_COUNT || BINARY_FRAME_HEADER_LEN + (size_t)payloadLength > length)
+        return false;
+
+    const char *name = messageTypeName((MessageType)code);
+    view.messageType = (MessageType)code;
+    view.type.data = name;
+    view.type.length = strlen(name);
+    view.sender = ((uint16_t)buffer[2] << 8) | buffer[3];
+    view.receiver = ((uint16_t)buffer[4] << 8) | buffer[5];
+
+    uint32_t ttlAndCount = ((uint32_t)buffer[6] << 24) | ((uint32_t)buffer[7] << 16) |
+                           ((uint32_t)buffer[8] << 8) | buffer[9];
+    view.ttl = ttlAndCount >> 28;
+    view.messageCount = ttlAndCount & BINARY_COUNTER_MASK;
+
+    size_t headerLength = BINARY_FRAME_HEADER_LEN;
+    if (buffer[1] & BINARY_FLAG_ROUTED)
+    {
+        headerLength += BINARY_ROUTE_LEN;
+        if (headerLength + (size_t)payloadLength > length)
+            return false;
+        view.hop = ((uint16_t)buffer[11] << 8) | buffer[12];
+        view.via = ((uint16_t)buffer[13] << 8) | buffer[14];
+    }
+
+    view.payload.data = (const char *)buffer + headerLength;
+    view.payload.length = payloadLength;
+    view.packedPayload = (buffer[1] & BINARY_FLAG_PACKED_PAYLOAD) != 0;
+    return true;
+}
+
+static bool parseAsciiView(const uint8_t *buffer, size_t length, LoRaMessageView &view)
+{
+    const char *raw = (const char *)buffer;
+    LoRaSlice fields[5];
+    uint8_t field = 0;
+    size_t start = 0;
+    uint8_t wanted = 3;
+
+    for (size_t i = 0; i < length && field < wanted; i++)
+    {
+        if (raw[i] != ':')
+            continue;
+
+        fields[field].data = raw + start;
+        fields[field].length = i - start;
+        start = i + 1;
+
+        // The type decides how many delimited fields precede the payload
+        if (field++ == 0)
+        {
+            view.messageType = messageTypeFromName(fields[0].data, fields[0].length);
+            if (hasTtlLayout(view.messageType))
+                wanted = 5;
+        }
+    }
+
+    if (field < wanted)
+        return false;
+
+    view.type = fields[0];
+    view.senderId = fields[1];
+    view.receiverId = fields[2];
+    view.sender = encodeNodeAddress(fields[1].data, fields[1].length);
+    view.receiver = encodeNodeAddress(fields[2].data, fields[2].length);
+    if (wanted == 5)
+    {
+        int64_t parsedTtl, parsedCount;
+        if (!parseSliceInt(fields[3], ASCII_TTL_LIMIT, parsedTtl) || !parseSliceInt(fields[4], ASCII_COUNTER_LIMIT, parsedCount))
+            return false;
+        view.ttl = (int)parsedTtl;
+        view.messageCount = (uint32_t)parsedCount;
+        parseSliceRoute(fields[3], view);
+    }
+    view.payload.data = raw + start;
+    view.payload.length = length - start;
+    return true;
+}
+
+bool parseMessageView(const uint8_t *buffer, size_t length, LoRaMessageView &view)
+{
+    view = LoRaMessageView();
+
+    if (length == 0 || length > LORA_MAX_FRAME_LEN)
+        return false;
+
+    view.valid = isBinaryFrame(buffer, length) ? parseBinaryView(buffer, length, view)
+                                               : parseAsciiView(buffer, length, view);
+    return view.valid;
+}
+
+LoRaMessage toMessage(const LoRaMessageView &view)
+{
+    LoRaMessage msg;
+
+    if (!view.valid)
+    {
+        msg.type = "INVALID";
+        return msg;
+    }
+
+    msg.type = view.type.toString();
+    msg.senderId = view.senderId.data ? view.senderId.toString() : decodeNodeAddress(view.sender);
+    msg.receiverId = view.receiverId.data ? view.receiverId.toString() : decodeNodeAddress(view.receiver);
+    msg.ttl = view.ttl;
+    msg.messageCount = view.messageCount;
+
+    if (view.packedPayload && view.payload.length)
+        msg.payload = base64Encode((uint8_t *)view.payload.data, view.payload.length);
+    else
+        msg.payload = view.payload.toString();
+
+    return msg;
+}
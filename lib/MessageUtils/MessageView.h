@@ -0,0 +1,66 @@
+// MessageView.h
+#ifndef MESSAGE_VIEW_H
+#define MESSAGE_VIEW_H
+
+#include <Arduino.h>
+#include "LoRaConfig.h"
+#include "MessageUtils.h"
+#include "BinaryFrame.h"
+#include "MessageType.h"
+
+/**
+ * Non-owning slice of a receive buffer (or of a constant string).
+ */
+struct LoRaSlice
+{
+    const char *data = nullptr;
+    uint8_t length = 0;
+
+    bool equals(const char *literal) const
+    {
+        size_t n = strlen(literal);
+        return n == length && memcmp(data, literal, n) == 0;
+    }
+
+    String toString() const;
+};
+
+/**
+ * Zero-copy view of a received frame (ASCII or binary).
+ * Slices point into the buffer passed to parseMessageView, so the view is only
+ * valid while that buffer is left untouched. Parsing never allocates.
+ */
+struct LoRaMessageView
+{
+    MessageType messageType = MessageType::INVALID; // Decoded once; INVALID for unknown types
+    LoRaSlice type;       // Points at a constant type name for binary frames
+    LoRaSlice senderId;   // Empty for binary frames; use `sender`
+    LoRaSlice receiverId; // Empty for binary frames; use `receiver`
+    LoRaSlice payload;    // Raw ciphertext when packedPayload is set
+    uint16_t sender = NODE_ADDR_INVALID;
+    uint16_t receiver = NODE_ADDR_INVALID;
+    int ttl = 0;
+    uint32_t messageCount = 0;
+    uint16_t hop = NODE_ADDR_INVALID;   // Transmitter of this copy, if the frame is routed
+    uint16_t via = NODE_ADDR_BROADCAST; // Designated next relay (BROADCAST = flood)
+    bool packedPayload = false;
+    bool valid = false;
+};
+
+/**
+ * Parses a received frame in place.
+ * ASCII frames of type MSG, CHAL and RESP (every type with LORA_CONTROL_TTL) are read as
+ * the 6-part TTL layout, every other ASCII type as the basic 4-part layout. A routed ASCII frame carries
+ * "<ttl>/<hop>/<via>" in its TTL field; nodes without LORA_ROUTING read only the TTL.
+ * Returns false (view.valid == false) if the frame is malformed, including an ASCII TTL
+ * above 32767 or a counter above 2^32 - 1.
+ */
+bool parseMessageView(const uint8_t *buffer, size_t length, LoRaMessageView &view);
+
+/**
+ * Copies a view into an owning LoRaMessage for the String-based handlers.
+ * Packed binary payloads are re-armoured as base64.
+ */
+LoRaMessage toMessage(const LoRaMessageView &view);
+
+#endif
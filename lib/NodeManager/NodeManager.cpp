@@ -1,55 +1,324 @@
 #include "NodeManager.h"
+#include "PeerKeys.h"
+#include "BinaryFrame.h"
+#include "KeystreamCache.h"
 
 // Global container for tracking all peer states
-std::vector<NodeState> peers;
+PeerTable peers;
+
+static PeerTableStats tableStats = {0, 0, 0, 0};
+
+// Compact address of a TX/RX/RL node; name-hash keys have role bits 00
+bool PeerTable::isPeerAddress(uint16_t key)
+{
+    return (key >> 14) != 0 && key != NODE_ADDR_BROADCAST;
+}
+
+/**
+ * Compact address for protocol IDs ("TX101"); FNV-1a for anything else, kept clear of the
+ * address values so the two kinds cannot collide. NODE_ADDR_INVALID for IDs no peer can have.
+ */
+uint16_t PeerTable::keyFor(const String &id)
+{
+    uint16_t address = encodeNodeAddress(id);
+    if (address == NODE_ADDR_BROADCAST || id.length() == 0 || id.length() > PEER_NAME_MAX_LEN)
+        return NODE_ADDR_INVALID;
+    if (address != NODE_ADDR_INVALID)
+        return address;
+
+    uint32_t hash = 2166136261UL;
+    for (size_t i = 0; i < id.length(); i++)
+        hash = (hash ^ (uint8_t)id[i]) * 16777619UL;
+    uint16_t key = (uint16_t)(hash ^ (hash >> 16)) & 0x3FFF; // Role bits 00 are never a valid address
+    return key != NODE_ADDR_INVALID ? key : 1;
+}
+
+// Fibonacci hashing: spreads consecutive device numbers across the table
+uint16_t PeerTable::homeSlot(uint16_t key)
+{
+    return (uint16_t)(key * 40503U) & (PEER_TABLE_CAPACITY - 1);
+}
+
+/**
+ * Linear probe from the key's home slot. Returns the slot holding key, or -1; *insertAt is
+ * set to the first reusable slot on the way (tombstone or empty), or -1 if the table is full.
+ * Name-hash keys also need `id` to match the stored name.
+ */
+int16_t PeerTable::locate(const String *id, uint16_t key, int16_t *insertAt)
+{
+    *insertAt = -1;
+    uint16_t slot = homeSlot(key);
+
+    for (uint16_t probe = 0; probe < PEER_TABLE_CAPACITY; probe++)
+    {
+        if (states[slot] == SLOT_EMPTY)
+        {
+            if (*insertAt < 0)
+                *insertAt = slot;
+            return -1;
+        }
+        if (states[slot] == SLOT_DELETED)
+        {
+            if (*insertAt < 0)
+                *insertAt = slot;
+        }
+        else if (keys[slot] == key &&
+                 (isPeerAddress(key) || (id && strcmp(names[slots[slot].nameSlot], id->c_str()) == 0)))
+        {
+            return slot;
+        }
+        slot = (slot + 1) & (PEER_TABLE_CAPACITY - 1);
+    }
+    return -1;
+}
+
+NodeState *PeerTable::find(const String &id)
+{
+    uint16_t key = keyFor(id);
+    if (key == NODE_ADDR_INVALID)
+        return nullptr;
+
+    int16_t insertAt;
+    int16_t slot = locate(&id, key, &insertAt);
+    return slot >= 0 ? &slots[slot] : nullptr;
+}
+
+NodeState *PeerTable::find(uint16_t address)
+{
+    if (!isPeerAddress(address))
+        return nullptr;
+
+    int16_t insertAt;
+    int16_t slot = locate(nullptr, address, &insertAt);
+    return slot >= 0 ? &slots[slot] : nullptr;
+}
+
+NodeState *PeerTable::findOrCreate(const String &id)
+{
+    uint16_t key = keyFor(id);
+    if (key == NODE_ADDR_INVALID)
+        return nullptr;
+
+    int16_t insertAt;
+    int16_t slot = locate(&id, key, &insertAt);
+    if (slot >= 0)
+        return &slots[slot];
+    if (insertAt < 0)
+        return nullptr;
+
+    uint8_t nameSlot = PEER_NO_NAME;
+    if (!isPeerAddress(key))
+    {
+        for (uint8_t i = 0; i < PEER_NAME_SLOTS && nameSlot == PEER_NO_NAME; i++)
+        {
+            if (names[i][0] == '\0')
+                nameSlot = i;
+        }
+        if (nameSlot == PEER_NO_NAME)
+            return nullptr;
+        strcpy(names[nameSlot], id.c_str()); // keyFor bounded the length
+    }
+
+    slots[insertAt] = NodeState();
+    material[insertAt] = PeerKeyMaterial();
+    slots[insertAt].address = key;
+    slots[insertAt].nameSlot = nameSlot;
+    keys[insertAt] = key;
+    states[insertAt] = SLOT_USED;
+    count++;
+    return &slots[insertAt];
+}
+
+void PeerTable::remove(NodeState *peer)
+{
+    if (!peer || peer < slots || peer >= slots + PEER_TABLE_CAPACITY)
+        return;
+
+    uint16_t slot = peer - slots;
+    if (states[slot] != SLOT_USED)
+        return;
+
+    resetPeer(peer); // Wipes key material
+    releaseName(peer);
+    peer->address = NODE_ADDR_INVALID;
+    states[slot] = SLOT_DELETED;
+    count--;
+
+    // A run of tombstones ending in an empty slot is not needed by any probe chain
+    if (states[(slot + 1) & (PEER_TABLE_CAPACITY - 1)] == SLOT_EMPTY)
+    {
+        while (states[slot] == SLOT_DELETED)
+        {
+            states[slot] = SLOT_EMPTY;
+            slot = (slot - 1) & (PEER_TABLE_CAPACITY - 1);
+        }
+    }
+}
+
+void PeerTable::clear()
+{
+    for (uint16_t slot = 0; slot < PEER_TABLE_CAPACITY; slot++)
+    {
+        if (states[slot] == SLOT_USED)
+        {
+            resetPeer(&slots[slot]);
+            releaseName(&slots[slot]);
+        }
+        slots[slot].address = NODE_ADDR_INVALID;
+        states[slot] = SLOT_EMPTY;
+    }
+    count = 0;
+}
+
+void PeerTable::releaseName(NodeState *peer)
+{
+    if (peer->nameSlot != PEER_NO_NAME)
+        names[peer->nameSlot][0] = '\0';
+    peer->nameSlot = PEER_NO_NAME;
+}
+
+String PeerTable::idOf(const NodeState *peer) const
+{
+    if (peer->nameSlot != PEER_NO_NAME)
+        return String(names[peer->nameSlot]);
+    return decodeNodeAddress(peer->address);
+}
+
+bool isPeerProtected(const NodeState *peer)
+{
+    return peer->state == PeerState::AUTHENTICATED || peer->state == PeerState::RESUMING;
+}
+
+// Least recently heard unprotected peer, or nullptr
+static NodeState *leastRecentlyHeard(unsigned long now)
+{
+    NodeState *victim = nullptr;
+    unsigned long oldestAge = 0;
+    for (auto &peer : peers)
+    {
+        if (isPeerProtected(&peer))
+            continue;
+
+        unsigned long age = now - peer.lastHeard; // Wrap-safe
+        if (!victim || age > oldestAge)
+        {
+            victim = &peer;
+            oldestAge = age;
+        }
+    }
+    return victim;
+}
 
 /**
  * Find an existing peer by ID or create a new one.
  */
 NodeState *findOrCreatePeer(const String &id)
 {
+    unsigned long now = millis();
+    NodeState *peer = peers.findOrCreate(id);
+
+    uint16_t address = encodeNodeAddress(id);
+    bool validId = address != NODE_ADDR_BROADCAST && id.length() > 0 && id.length() <= PEER_NAME_MAX_LEN;
+
+    if (!peer && validId && peers.size() == peers.capacity())
+    {
+        NodeState *victim = leastRecentlyHeard(now);
+        if (victim)
+        {
+            Serial.println("♻️  Peer table full. Evicting " + peerId(victim) + " for " + id);
+            peers.remove(victim);
+            tableStats.lruEvictions++;
+            peer = peers.findOrCreate(id);
+        }
+    }
+
+    if (!peer)
+    {
+        Serial.println("🚫 Peer table cannot take " + id +
+                       (validId ? " (every entry protected, or no free name slot)" : " (invalid ID)"));
+        tableStats.rejected++;
+        return nullptr;
+    }
+
+    peer->lastHeard = now;
+    if (peers.size() > tableStats.highWater)
+        tableStats.highWater = peers.size();
+    return peer;
+}
+
+void touchPeer(const String &id)
+{
+    NodeState *peer = peers.find(id);
+    if (peer)
+        peer->lastHeard = millis();
+}
+
+uint8_t evictIdlePeers()
+{
+    unsigned long now = millis();
+    uint8_t removed = 0;
+
     for (auto &peer : peers)
     {
-        if (peer.id == id)
-            return &peer;
+        if (isPeerProtected(&peer) || now - peer.lastHeard < LORA_PEER_IDLE_TIMEOUT_MS)
+            continue;
+
+        Serial.println("⌛ Evicting idle peer " + peerId(&peer));
+        peers.remove(&peer); // Slots never move, so iteration continues safely
+        tableStats.idleEvictions++;
+        removed++;
     }
+    return removed;
+}
 
-    NodeState newPeer;
-    newPeer.id = id;
-    newPeer.state = PeerState::IDLE;
-    peers.push_back(newPeer);
-    return &peers.back();
+const PeerTableStats &peerTableStats()
+{
+    return tableStats;
+}
+
+void printPeerTableStatus()
+{
+    uint16_t authenticated = 0;
+    for (const auto &peer : peers)
+    {
+        if (isPeerProtected(&peer))
+            authenticated++;
+    }
+
+    Serial.println("\n========= Peer Table =========");
+    unsigned long bytesPerPeer = sizeof(NodeState) + sizeof(PeerKeyMaterial) + 3; // + key and slot state
+    Serial.println("📇 In Use: " + String(peers.size()) + "/" + String(peers.capacity()) +
+                   " (" + String(peers.capacity() * bytesPerPeer + PEER_NAME_SLOTS * (PEER_NAME_MAX_LEN + 1)) + " bytes)");
+    Serial.println("📏 Bytes per Peer: " + String((unsigned long)sizeof(NodeState)) + " hot + " +
+                   String((unsigned long)sizeof(PeerKeyMaterial)) + " key pair");
+    Serial.println("🛡️  Protected: " + String(authenticated));
+    Serial.println("📈 High Water: " + String(tableStats.highWater));
+    Serial.println("♻️  LRU Evictions: " + String(tableStats.lruEvictions));
+    Serial.println("⌛ Idle Evictions: " + String(tableStats.idleEvictions));
+    Serial.println("🚫 Rejected: " + String(tableStats.rejected));
+    Serial.println("==============================\n");
 }
 
 /**
  * Mark the peer as having received an ACK.
  * If both ACK and PK were exchanged, promote to SECURE_COMM.
  */
-void markPeerAckReceived(const String &id)
+void markPeerAckReceived(NodeState *peer)
 {
-    for (auto &peer : peers)
-    {
-        if (peer.id == id)
-        {
-            peer.ackReceived = true;
-
-            if (peer.state == PeerState::ACK_PENDING && peer.ackSent)
-            {
-                peer.state = PeerState::SECURE_COMM;
-                Serial.println("✅ ACK exchange complete. Transitioning to SECURE_COMM for " + peer.id);
-            }
+    peer->ackReceived = true;
 
-            break;
-        }
+    if (peer->state == PeerState::ACK_PENDING && peer->ackSent)
+    {
+        peer->state = PeerState::SECURE_COMM;
+        Serial.println("✅ ACK exchange complete. Transitioning to SECURE_COMM for " + peerId(peer));
     }
 }
 
 /**
  * Check if DH exchange is completed with this peer.
  */
-bool isPeerDHComplete(const String &id)
+bool isPeerDHComplete(const NodeState *peer)
 {
-    NodeState *peer = findOrCreatePeer(id);
     return peer->pkReceived && peer->ackReceived && peer->sharedSessionKey != 0;
 }
 
@@ -61,16 +330,32 @@ void resetPeer(NodeState *peer)
     if (!peer)
         return;
 
-    peer->privateKey = 0;
-    peer->publicKey = 0;
-    peer->remotePublicKey = 0;
+    keyMaterial(peer) = PeerKeyMaterial();
     peer->sharedSessionKey = 0;
+    forgetKeystreams(peer->sendKey);
+    forgetKeystreams(peer->receiveKey);
+    memset(peer->sendKey, 0, sizeof(peer->sendKey));
+    memset(peer->receiveKey, 0, sizeof(peer->receiveKey));
+    memset(peer->authKey, 0, sizeof(peer->authKey));
+    peer->sendEpoch = 0;
+    peer->receiveEpoch = 0;
+    peer->sendEpochStartedAt = 0;
+    peer->awaitingAnnouncement = false;
+    peer->announceAttempts = 0;
     peer->pkSent = false;
     peer->pkReceived = false;
     peer->ackSent = false;
     peer->ackReceived = false;
     peer->messageCount = 0;
     peer->challenge = 0;
+    peer->replayHighest = 0;
+    peer->replayWindow = 0;
+    peer->replaysDropped = 0;
+    peer->ticketCounterLimit = 0;
+    peer->resumeSentAt = 0;
+    peer->resumeAttempts = 0;
+    peer->handshakeSentAt = 0;
+    peer->handshakeAttempts = 0;
     peer->state = PeerState::IDLE;
 }
 
@@ -82,15 +367,114 @@ void printPeerStatus()
     Serial.println("\n========= Connected Nodes =========");
     for (const auto &peer : peers)
     {
-        Serial.println("📡 ID: " + peer.id);
-        Serial.println("🔑 Private Key: " + String(peer.privateKey));
-        Serial.println("🔓 Public Key: " + String(peer.publicKey));
-        Serial.println("🔒 Remote Public Key: " + String(peer.remotePublicKey));
-        Serial.println("🤝 Shared Session Key: " + String(peer.sharedSessionKey));
+        Serial.println("📡 ID: " + peerId(&peer));
+        Serial.println("🔓 Public Key: " + publicKeyPayload(&peer));
+        Serial.println("🔒 Remote Public Key: " + remotePublicKeyString(&peer));
+        Serial.println("🤝 Shared Session Key: " + sessionKeyString(&peer));
         Serial.println("✅ PK Sent: " + String(peer.pkSent ? "Yes" : "No"));
         Serial.println("✅ PK Received: " + String(peer.pkReceived ? "Yes" : "No"));
         Serial.println("✅ ACK Received: " + String(peer.ackReceived ? "Yes" : "No"));
+        Serial.println("🔄 Key Epochs (send/receive): " + String(peer.sendEpoch) + "/" + String(peer.receiveEpoch));
+        Serial.println("🔁 Replays Dropped: " + String(peer.replaysDropped));
         Serial.println("-----------------------------------");
     }
     Serial.println("===================================\n");
 }
+
+/**
+ * Sliding-window replay check (highest accepted counter + 64-bit bitmap behind it).
+ * Frames reordered over multi-hop paths are accepted as long as they are within the window.
+ */
+bool isReplayedCounter(const NodeState *peer, uint32_t messageCount)
+{
+    if (messageCount > peer->replayHighest)
+        return false;
+
+    uint32_t age = peer->replayHighest - messageCount;
+    if (age >= REPLAY_WINDOW_SIZE)
+        return true; // Too old to tell apart from a replay
+
+    return (peer->replayWindow >> age) & 1;
+}
+
+/**
+ * Slide the window forward (or mark a bit inside it) for an authenticated counter.
+ */
+void acceptCounter(NodeState *peer, uint32_t messageCount)
+{
+    if (messageCount > peer->replayHighest)
+    {
+        uint32_t shift = messageCount - peer->replayHighest;
+        peer->replayWindow = shift >= REPLAY_WINDOW_SIZE ? 0 : peer->replayWindow << shift;
+        peer->replayHighest = messageCount;
+        peer->replayWindow |= 1;
+    }
+    else
+    {
+        peer->replayWindow |= 1ULL << (peer->replayHighest - messageCount);
+    }
+}
+
+/**
+ * Queue a discovered peer for the next broadcast PK announcement.
+ */
+void queuePeerForAnnouncement(NodeState *peer)
+{
+    if (peer->pkReceived || peer->awaitingAnnouncement)
+        return;
+
+    peer->awaitingAnnouncement = true;
+    peer->announceAttempts = 0;
+}
+
+/**
+ * The peer answered our announcement with its own PK.
+ */
+void markPeerAnnouncementAcked(NodeState *peer)
+{
+    if (peer->awaitingAnnouncement)
+        Serial.println("📣 " + peerId(peer) + " acknowledged our PK announcement");
+
+    peer->awaitingAnnouncement = false;
+}
+
+/**
+ * Number of peers that still need a broadcast PK.
+ */
+uint8_t countPeersAwaitingAnnouncement()
+{
+    uint8_t count = 0;
+    for (const auto &peer : peers)
+    {
+        if (peer.awaitingAnnouncement)
+            count++;
+    }
+    return count;
+}
+
+/**
+ * Account for one broadcast PK covering every waiting peer; returns how many it covers
+ * (0 = nothing to send). Peers that stayed silent for PK_ANNOUNCE_ATTEMPTS broadcasts are
+ * reset instead; PING rediscovers them.
+ */
+uint8_t preparePkAnnouncement()
+{
+    uint8_t covered = 0;
+    for (auto &peer : peers)
+    {
+        if (!peer.awaitingAnnouncement)
+            continue;
+
+        if (peer.announceAttempts >= PK_ANNOUNCE_ATTEMPTS)
+        {
+            Serial.println("⌛ " + peerId(&peer) + " did not answer our PK announcement. Resetting.");
+            resetPeer(&peer);
+            continue;
+        }
+
+        peer.announceAttempts++;
+        peer.pkSent = true;
+        covered++;
+    }
+    return covered;
+}
@@ -2,50 +2,278 @@
 #define NODE_MANAGER_H
 
 #include <Arduino.h>
-#include <vector>
+#include "LoRaConfig.h"
+#include "X25519.h"
+#include "EncryptionUtils.h"
+#include "BinaryFrame.h"
 
 // ========== ENUM: Peer FSM States ==========
-enum class PeerState
+enum class PeerState : uint8_t
 {
     IDLE,         // Default/reset state
     ACK_PENDING,  // Waiting for ACK exchange
     SECURE_COMM,  // DH key exchange complete
     CHAL_SENT,    // CHAL sent, waiting for RESP
-    AUTHENTICATED // Fully authenticated, secure channel
+    AUTHENTICATED, // Fully authenticated, secure channel
+    RESUMING,      // Session restored from EEPROM, RESUME sent, waiting for RESUMED
+    KX_SENT        // 1-RTT handshake: KX_INIT sent, waiting for KX_CONFIRM
 };
 
+#define PEER_NO_NAME 0xFF
+#define PEER_NAME_MAX_LEN 19 // Longest device ID loadDeviceIdFromEEPROM returns
+
 // ========== STRUCT: NodeState ==========
-// Represents the status and keys for each peer
+// Per-peer state touched on every frame and by the retry/send loops. Fields are ordered
+// by size so the struct has no padding; the DH key pairs live in PeerKeyMaterial.
 struct NodeState
 {
-    String id;
+    NodeState()
+        : awaitingAnnouncement(false), pkSent(false), pkReceived(false), ackSent(false), ackReceived(false)
+    {
+    }
+
+    // Traffic keys (KeySchedule.h), derived from the DH secret in both modes
+    uint8_t sendKey[SESSION_KEY_SIZE] = {0};    // Encrypts our CHAL/RESP/MSG/RESUME frames
+    uint8_t receiveKey[SESSION_KEY_SIZE] = {0}; // Decrypts the peer's frames
+    uint8_t authKey[SESSION_KEY_SIZE] = {0};    // Challenge responses and the 1-RTT transcript MAC
+
+    // Anti-replay for received MSG counters: bit i of replayWindow = (replayHighest - i) accepted
+    uint64_t replayWindow = 0;
+    uint32_t replayHighest = 0;
+
+    uint32_t messageCount = 0;
+    uint32_t challenge = 0;
+    uint32_t sharedSessionKey = 0; // Nonzero once traffic keys exist; the DH secret is not kept
+    uint32_t sendEpoch = 0;        // Ratchet position of sendKey
+    uint32_t receiveEpoch = 0;     // Ratchet position of receiveKey
+    uint32_t ticketCounterLimit = 0; // Counter high-water mark stored in the EEPROM ticket (SessionTicket.h)
+
+    // Timers (millis)
+    unsigned long sendEpochStartedAt = 0; // For the LORA_REKEY_INTERVAL_MS rekey
+    unsigned long resumeSentAt = 0;       // Session resumption
+    unsigned long handshakeSentAt = 0;    // 1-RTT handshake (FastHandshake.h)
+    unsigned long lastHeard = 0;          // Last frame from this peer (eviction)
 
-    // Key material
+    uint16_t address = NODE_ADDR_INVALID; // Table key: compact node address, or a name hash (see PeerTable)
+    uint16_t replaysDropped = 0;
+
+    // FSM state and handshake flags share one 16-bit word
+    PeerState state = PeerState::IDLE;
+    bool awaitingAnnouncement : 1; // Discovered, waiting for our broadcast PK to be answered
+    bool pkSent : 1;
+    bool pkReceived : 1;
+    bool ackSent : 1;
+    bool ackReceived : 1;
+
+    uint8_t announceAttempts = 0; // Broadcast PKs sent while awaitingAnnouncement
+    uint8_t resumeAttempts = 0;
+    uint8_t handshakeAttempts = 0;
+    uint8_t nameSlot = PEER_NO_NAME; // PeerTable name slot holding the ID if it has no compact address
+};
+
+// ========== STRUCT: PeerKeyMaterial ==========
+// DH key pairs. The private key is wiped once the traffic keys are derived
+// (deriveSessionKey); the public halves stay to recognise repeated PK and KX_INIT
+// frames. Kept apart from NodeState so the loops that scan every peer do not pull
+// them through the cache; see keyMaterial().
+struct PeerKeyMaterial
+{
+#if LORA_X25519
+    uint8_t privateKey25519[X25519_KEY_SIZE] = {0};
+    uint8_t publicKey25519[X25519_KEY_SIZE] = {0};
+    uint8_t remotePublicKey25519[X25519_KEY_SIZE] = {0};
+#else
+    // Legacy 31-bit DH
     uint32_t privateKey = 0;
     uint32_t publicKey = 0;
     uint32_t remotePublicKey = 0;
-    uint32_t sharedSessionKey = 0;
+#endif
+};
 
-    // Handshake tracking
-    bool pkSent = false;
-    bool pkReceived = false;
-    bool ackSent = false;
-    bool ackReceived = false;
+// ========== Peer table ==========
+// Fixed-capacity open-addressing table keyed on the compact node address (encodeNodeAddress).
+// IDs that do not encode ("RX001", "TXA") are keyed on FNV-1a folded into role bits 00,
+// which no address uses, and keep their full ID in one of LORA_MAX_NAMED_PEERS name slots;
+// a key match on such a peer also compares the ID. Entries never move, so a NodeState*
+// stays valid until that peer is removed. NodeState and PeerKeyMaterial sit in parallel arrays.
+#define PEER_TABLE_CAPACITY LORA_MAX_PEERS
+#define PEER_NAME_SLOTS LORA_MAX_NAMED_PEERS
 
-    // Challenge-response
-    uint32_t challenge = 0;
-    uint32_t messageCount = 0;
+static_assert(PEER_NAME_SLOTS < PEER_NO_NAME, "LORA_MAX_NAMED_PEERS must be below 255");
 
-    PeerState state = PeerState::IDLE;
+static_assert((PEER_TABLE_CAPACITY & (PEER_TABLE_CAPACITY - 1)) == 0, "LORA_MAX_PEERS must be a power of two");
+
+class PeerTable
+{
+public:
+    enum SlotState : uint8_t
+    {
+        SLOT_EMPTY,
+        SLOT_USED,
+        SLOT_DELETED // Tombstone: keeps probe chains intact, reused by inserts
+    };
+
+    // Visits used slots in slot order
+    template <typename Table, typename Peer>
+    class Iterator
+    {
+    public:
+        Iterator(Table *table, uint16_t index) : table(table), index(index) { skipUnused(); }
+        Peer &operator*() const { return table->slots[index]; }
+        Peer *operator->() const { return &table->slots[index]; }
+        Iterator &operator++()
+        {
+            index++;
+            skipUnused();
+            return *this;
+        }
+        bool operator!=(const Iterator &other) const { return index != other.index; }
+
+    private:
+        void skipUnused()
+        {
+            while (index < PEER_TABLE_CAPACITY && table->states[index] != SLOT_USED)
+                index++;
+        }
+        Table *table;
+        uint16_t index;
+    };
+
+    typedef Iterator<PeerTable, NodeState> iterator;
+    typedef Iterator<const PeerTable, const NodeState> const_iterator;
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, PEER_TABLE_CAPACITY); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, PEER_TABLE_CAPACITY); }
+
+    uint16_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    uint16_t capacity() const { return PEER_TABLE_CAPACITY; }
+
+    NodeState *find(const String &id);
+    NodeState *find(uint16_t address); // Compact addresses only
+
+    /**
+     * Existing entry for id, else a fresh IDLE entry. nullptr if the table is full, id
+     * is "ALL", empty or longer than PEER_NAME_MAX_LEN, or id has no compact address and
+     * every name slot is taken.
+     */
+    NodeState *findOrCreate(const String &id);
+
+    /**
+     * Device ID of a peer returned by this table.
+     */
+    String idOf(const NodeState *peer) const;
+
+    /**
+     * Frees the peer's slot. Pointers to it become invalid.
+     */
+    void remove(NodeState *peer);
+    void clear();
+
+    /**
+     * DH key pair for a peer returned by this table.
+     */
+    PeerKeyMaterial &keyMaterial(const NodeState *peer) { return material[peer - slots]; }
+
+private:
+    static bool isPeerAddress(uint16_t key);
+    static uint16_t keyFor(const String &id);
+    static uint16_t homeSlot(uint16_t key);
+    int16_t locate(const String *id, uint16_t key, int16_t *insertAt);
+    void releaseName(NodeState *peer);
+
+    NodeState slots[PEER_TABLE_CAPACITY];
+    PeerKeyMaterial material[PEER_TABLE_CAPACITY];
+    uint16_t keys[PEER_TABLE_CAPACITY] = {0};
+    SlotState states[PEER_TABLE_CAPACITY] = {SLOT_EMPTY};
+    char names[PEER_NAME_SLOTS][PEER_NAME_MAX_LEN + 1] = {{0}}; // "" = free
+    uint16_t count = 0;
 };
 
 // ========== Peer Management ==========
-extern std::vector<NodeState> peers;
+extern PeerTable peers;
 
+/**
+ * Find an existing peer by ID or create a new one, and mark it as heard now.
+ * A full table evicts its least recently heard unprotected peer (see isPeerProtected).
+ * Returns nullptr, with a log line, for "ALL", empty or overlong IDs, when every entry is
+ * protected, and for an ID without a compact address when every name slot is taken. The returned pointer stays valid until the peer is removed; only
+ * findOrCreatePeer (for a new ID) and evictIdlePeers remove peers.
+ */
 NodeState *findOrCreatePeer(const String &id);
-void markPeerAckReceived(const String &id);
-bool isPeerDHComplete(const String &id);
+
+/**
+ * Textual device ID of a peer ("TX101").
+ */
+inline String peerId(const NodeState *peer)
+{
+    return peers.idOf(peer);
+}
+
+/**
+ * DH key pair of a peer in the global table.
+ */
+inline PeerKeyMaterial &keyMaterial(const NodeState *peer)
+{
+    return peers.keyMaterial(peer);
+}
+
+/**
+ * Updates lastHeard for a known peer without creating one (e.g. on PING).
+ */
+void touchPeer(const String &id);
+
+// ========== Eviction ==========
+struct PeerTableStats
+{
+    uint32_t lruEvictions;  // Peers replaced because the table was full
+    uint32_t idleEvictions; // Peers removed after LORA_PEER_IDLE_TIMEOUT_MS
+    uint32_t rejected;      // New peers refused: invalid ID, every entry protected, or no name slot
+    uint16_t highWater;     // Most entries in use at once
+};
+
+/**
+ * Authenticated peers (and sessions being resumed) are never evicted.
+ */
+bool isPeerProtected(const NodeState *peer);
+
+/**
+ * Removes unprotected peers not heard for LORA_PEER_IDLE_TIMEOUT_MS.
+ * Returns the number removed. Call periodically from the loop.
+ */
+uint8_t evictIdlePeers();
+
+const PeerTableStats &peerTableStats();
+void printPeerTableStatus();
+
+void markPeerAckReceived(NodeState *peer);
+bool isPeerDHComplete(const NodeState *peer);
 void resetPeer(NodeState *peer);
 void printPeerStatus();
 
+// ========== Anti-replay ==========
+#define REPLAY_WINDOW_SIZE 64
+
+/**
+ * O(1) check of a received counter against the peer's sliding window, done before decryption.
+ * Returns true for a counter already accepted or older than the window.
+ */
+bool isReplayedCounter(const NodeState *peer, uint32_t messageCount);
+
+/**
+ * Records a counter as accepted. Call only after the frame authenticated, so forged
+ * frames cannot advance the window.
+ */
+void acceptCounter(NodeState *peer, uint32_t messageCount);
+
+// ========== Broadcast key announcement (LORA_BROADCAST_PK) ==========
+#define PK_ANNOUNCE_ATTEMPTS 5 // Broadcasts before an unanswering peer is dropped
+
+void queuePeerForAnnouncement(NodeState *peer);
+void markPeerAnnouncementAcked(NodeState *peer);
+uint8_t countPeersAwaitingAnnouncement();
+uint8_t preparePkAnnouncement();
+
 #endif
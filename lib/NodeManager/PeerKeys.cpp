@@ -0,0 +1,301 @@
+#include "PeerKeys.h"
+#include "DHExchange.h"
+#include "KeySchedule.h"
+#include "KeystreamCache.h"
+
+// New traffic keys start at epoch 0 in both directions
+static void startTrafficKeys(NodeState *peer)
+{
+    peer->sendEpoch = 0;
+    peer->receiveEpoch = 0;
+    peer->sendEpochStartedAt = millis();
+}
+
+static String hexString(const uint8_t *data, size_t length)
+{
+    static const char digits[] = "0123456789abcdef";
+    String s;
+    s.reserve(length * 2);
+    for (size_t i = 0; i < length; i++)
+    {
+        s += digits[data[i] >> 4];
+        s += digits[data[i] & 0x0F];
+    }
+    return s;
+}
+
+String sessionKeyString(const NodeState *peer)
+{
+    return hexString(peer->sendKey, SESSION_KEY_SIZE);
+}
+
+#if LORA_X25519
+
+static bool isZeroKey(const uint8_t *key, size_t length)
+{
+    uint8_t acc = 0;
+    for (size_t i = 0; i < length; i++)
+        acc |= key[i];
+    return acc == 0;
+}
+
+#if LORA_BROADCAST_PK
+// One key pair per boot shared by every peer, so a single announcement serves all of them
+// (and the scalar multiplication for the public key runs once instead of once per peer)
+static uint8_t nodePrivateKey25519[X25519_KEY_SIZE];
+static uint8_t nodePublicKey25519[X25519_KEY_SIZE];
+static bool nodeKeysReady = false;
+
+static void ensureNodeKeys(uint32_t seed)
+{
+    if (nodeKeysReady)
+        return;
+
+    generatePrivateKey25519(seed, nodePrivateKey25519);
+    generatePublicKey25519(nodePrivateKey25519, nodePublicKey25519);
+    nodeKeysReady = true;
+}
+#endif
+
+void createLocalKeys(NodeState *peer, uint32_t seed)
+{
+    if (hasLocalKeys(peer))
+        return;
+
+    PeerKeyMaterial &keys = keyMaterial(peer);
+#if LORA_BROADCAST_PK
+    ensureNodeKeys(seed);
+    memcpy(keys.privateKey25519, nodePrivateKey25519, X25519_KEY_SIZE);
+    memcpy(keys.publicKey25519, nodePublicKey25519, X25519_KEY_SIZE);
+#else
+    generatePrivateKey25519(seed, keys.privateKey25519);
+    generatePublicKey25519(keys.privateKey25519, keys.publicKey25519);
+#endif
+}
+
+bool hasLocalKeys(const NodeState *peer)
+{
+    return !isZeroKey(keyMaterial(peer).publicKey25519, X25519_KEY_SIZE);
+}
+
+String publicKeyPayload(const NodeState *peer)
+{
+    return base64Encode((uint8_t *)keyMaterial(peer).publicKey25519, X25519_KEY_SIZE);
+}
+
+bool storeRemotePublicKey(NodeState *peer, const String &payload)
+{
+    uint8_t decoded[X25519_KEY_SIZE + 3];
+    size_t length = 0;
+
+    if (payload.length() != 44 || !base64Decode(payload, decoded, &length) || length != X25519_KEY_SIZE)
+        return false;
+
+    memcpy(keyMaterial(peer).remotePublicKey25519, decoded, X25519_KEY_SIZE);
+    return true;
+}
+
+bool hasRemotePublicKey(const NodeState *peer)
+{
+    return !isZeroKey(keyMaterial(peer).remotePublicKey25519, X25519_KEY_SIZE);
+}
+
+bool remotePublicKeyMatches(const NodeState *peer, const String &payload)
+{
+    return hasRemotePublicKey(peer) && remotePublicKeyString(peer) == payload;
+}
+
+bool deriveSessionKey(NodeState *peer, const String &selfId)
+{
+    if (peer->sharedSessionKey != 0)
+        return true;
+    if (!hasLocalKeys(peer) || !hasRemotePublicKey(peer))
+        return false;
+
+    PeerKeyMaterial &keys = keyMaterial(peer);
+    uint8_t shared[X25519_KEY_SIZE];
+    if (!generateSharedKey25519(keys.remotePublicKey25519, keys.privateKey25519, shared))
+        return false;
+
+    deriveTrafficKeys(shared, sizeof(shared), selfId, peerId(peer), peer->sendKey, peer->receiveKey, peer->authKey);
+    startTrafficKeys(peer);
+    peer->sharedSessionKey = 1; // Keys are present; the secret itself is not kept
+
+    // Neither the secret nor our private key is needed again. The public halves stay:
+    // repeated PK and KX_INIT frames are recognised by comparing them.
+    memset(shared, 0, sizeof(shared));
+    memset(keys.privateKey25519, 0, X25519_KEY_SIZE);
+    return true;
+}
+
+String remotePublicKeyString(const NodeState *peer)
+{
+    return base64Encode((uint8_t *)keyMaterial(peer).remotePublicKey25519, X25519_KEY_SIZE);
+}
+
+#else
+
+void createLocalKeys(NodeState *peer, uint32_t seed)
+{
+    if (hasLocalKeys(peer))
+        return;
+
+    PeerKeyMaterial &keys = keyMaterial(peer);
+    keys.privateKey = generatePrivateKey(seed);
+    keys.publicKey = generatePublicKey(keys.privateKey);
+}
+
+bool hasLocalKeys(const NodeState *peer)
+{
+    return keyMaterial(peer).publicKey != 0; // The private key is wiped after derivation
+}
+
+String publicKeyPayload(const NodeState *peer)
+{
+    return String(keyMaterial(peer).publicKey);
+}
+
+bool storeRemotePublicKey(NodeState *peer, const String &payload)
+{
+    uint32_t key = payload.toInt();
+    if (key == 0)
+        return false;
+
+    keyMaterial(peer).remotePublicKey = key;
+    return true;
+}
+
+bool hasRemotePublicKey(const NodeState *peer)
+{
+    return keyMaterial(peer).remotePublicKey != 0;
+}
+
+bool remotePublicKeyMatches(const NodeState *peer, const String &payload)
+{
+    return hasRemotePublicKey(peer) && keyMaterial(peer).remotePublicKey == (uint32_t)payload.toInt();
+}
+
+bool deriveSessionKey(NodeState *peer, const String &selfId)
+{
+    if (peer->sharedSessionKey != 0)
+        return true;
+    if (!hasLocalKeys(peer) || !hasRemotePublicKey(peer))
+        return false;
+
+    PeerKeyMaterial &keys = keyMaterial(peer);
+    uint32_t secret = generateSharedKey(keys.remotePublicKey, keys.privateKey);
+    if (secret == 0)
+        return false;
+
+    uint8_t shared[4];
+    for (uint8_t i = 0; i < 4; i++)
+        shared[i] = (secret >> (8 * i)) & 0xFF;
+    deriveTrafficKeys(shared, sizeof(shared), selfId, peerId(peer), peer->sendKey, peer->receiveKey, peer->authKey);
+    startTrafficKeys(peer);
+    peer->sharedSessionKey = 1; // Keys are present; the secret itself is not kept
+
+    memset(shared, 0, sizeof(shared));
+    keys.privateKey = 0;
+    return true;
+}
+
+String remotePublicKeyString(const NodeState *peer)
+{
+    return String(keyMaterial(peer).remotePublicKey);
+}
+
+#endif
+
+// ========== Traffic encryption (both key exchange modes) ==========
+
+static const uint8_t *sendKeyFor(NodeState *peer, uint32_t messageCount)
+{
+    uint32_t epoch = keyEpoch(messageCount);
+    if (epoch > peer->sendEpoch)
+    {
+        forgetKeystreams(peer->sendKey);
+        while (peer->sendEpoch < epoch)
+        {
+            ratchetKey(peer->sendKey);
+            peer->sendEpoch++;
+        }
+        peer->sendEpochStartedAt = millis();
+        Serial.println("🔄 Send key for " + peerId(peer) + " ratcheted to epoch " + String(peer->sendEpoch));
+    }
+    return peer->sendKey;
+}
+
+String encryptForPeer(NodeState *peer, const String &plainText, uint32_t messageCount, const String &associatedData)
+{
+    return encryptPayload(plainText, sendKeyFor(peer, messageCount), messageCount, associatedData);
+}
+
+bool decryptFromPeer(NodeState *peer, const String &encryptedText, uint32_t messageCount,
+                     const String &associatedData, String &plainText)
+{
+    uint32_t epoch = keyEpoch(messageCount);
+    if (epoch < peer->receiveEpoch || epoch - peer->receiveEpoch > LORA_REKEY_MAX_SKIP)
+        return false;
+
+    if (epoch == peer->receiveEpoch)
+        return decryptPayload(encryptedText, peer->receiveKey, messageCount, associatedData, plainText);
+
+    // Ratchet a copy; a forged frame with a far-ahead counter must not move the real chain
+    uint8_t candidate[SESSION_KEY_SIZE];
+    memcpy(candidate, peer->receiveKey, SESSION_KEY_SIZE);
+    for (uint32_t e = peer->receiveEpoch; e < epoch; e++)
+        ratchetKey(candidate);
+
+    bool ok = decryptPayload(encryptedText, candidate, messageCount, associatedData, plainText);
+    if (ok)
+    {
+        forgetKeystreams(peer->receiveKey);
+        memcpy(peer->receiveKey, candidate, SESSION_KEY_SIZE);
+        peer->receiveEpoch = epoch;
+        Serial.println("🔄 Receive key for " + peerId(peer) + " ratcheted to epoch " + String(epoch));
+    }
+    memset(candidate, 0, sizeof(candidate));
+    return ok;
+}
+
+void rekeyIfDue(NodeState *peer)
+{
+    if (peer->sharedSessionKey == 0 || millis() - peer->sendEpochStartedAt < LORA_REKEY_INTERVAL_MS)
+        return;
+    if (keyEpoch(peer->messageCount) > peer->sendEpoch) // Already moved, not yet sent under it
+        return;
+
+    // Keystream precomputed for the rest of this epoch will never be used
+    forgetKeystreams(peer->sendKey);
+    peer->messageCount = (keyEpoch(peer->messageCount) + 1) * LORA_REKEY_FRAMES;
+}
+
+bool precomputeKeystreams(uint8_t directions)
+{
+    uint8_t covered = 0;
+    for (auto &peer : peers)
+    {
+        if (peer.state != PeerState::AUTHENTICATED)
+            continue;
+        if (covered == LORA_KEYSTREAM_CACHE_PEERS)
+            break;
+        covered++;
+
+        // Only counters in the current epoch: a frame that ratchets the key misses anyway
+        if ((directions & KEYSTREAM_SEND) && keyEpoch(peer.messageCount) == peer.sendEpoch &&
+            precomputeKeystream(peer.sendKey, peer.messageCount))
+            return true;
+
+        uint32_t expected = peer.replayHighest + 1;
+        if ((directions & KEYSTREAM_RECEIVE) && keyEpoch(expected) == peer.receiveEpoch &&
+            precomputeKeystream(peer.receiveKey, expected))
+            return true;
+    }
+    return false;
+}
+
+uint32_t authToken(const NodeState *peer)
+{
+    return (uint32_t)peer->authKey[0] | ((uint32_t)peer->authKey[1] << 8) |
+           ((uint32_t)peer->authKey[2] << 16) | ((uint32_t)peer->authKey[3] << 24);
+}
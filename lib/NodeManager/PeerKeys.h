@@ -0,0 +1,89 @@
+#ifndef PEER_KEYS_H
+#define PEER_KEYS_H
+
+#include <Arduino.h>
+#include "LoRaConfig.h"
+#include "NodeManager.h"
+
+// ========== Key exchange on NodeState ==========
+// Hides whether the peer uses X25519 or the legacy 31-bit DH (LORA_X25519),
+// so the handshake handlers are the same for both.
+
+/**
+ * Generates our key pair for this peer, unless one already exists.
+ * With LORA_BROADCAST_PK every peer gets the same node-wide key pair.
+ */
+void createLocalKeys(NodeState *peer, uint32_t seed);
+
+bool hasLocalKeys(const NodeState *peer);
+
+/**
+ * Our public key as carried in a PK payload: base64 (X25519) or decimal (legacy).
+ */
+String publicKeyPayload(const NodeState *peer);
+
+/**
+ * Stores the peer's public key from a PK payload.
+ * Returns false (and stores nothing) if the payload is malformed.
+ */
+bool storeRemotePublicKey(NodeState *peer, const String &payload);
+
+bool hasRemotePublicKey(const NodeState *peer);
+
+/**
+ * True if the stored remote key equals the key in this PK payload.
+ */
+bool remotePublicKeyMatches(const NodeState *peer, const String &payload);
+
+/**
+ * Derives the traffic keys (KeySchedule.h) once both key halves are present. The DH secret
+ * and this peer's copy of our private key are wiped afterwards; the public keys are kept.
+ * Returns true if the peer has traffic keys.
+ */
+bool deriveSessionKey(NodeState *peer, const String &selfId);
+
+// ========== Traffic encryption ==========
+
+/**
+ * Encrypts a payload we send under the send key for this counter's epoch,
+ * ratcheting the send key forward first if the counter entered a new epoch.
+ * Counters must not go backwards within a session.
+ */
+String encryptForPeer(NodeState *peer, const String &plainText, uint32_t messageCount, const String &associatedData);
+
+/**
+ * Decrypts a payload from the peer. Frames up to LORA_REKEY_MAX_SKIP epochs ahead are tried
+ * under a ratcheted copy of the receive key, which is kept only if the frame authenticates.
+ * Frames from an epoch we already left cannot be decrypted.
+ */
+bool decryptFromPeer(NodeState *peer, const String &encryptedText, uint32_t messageCount,
+                     const String &associatedData, String &plainText);
+
+/**
+ * Time-based rekey: if the current send epoch is older than LORA_REKEY_INTERVAL_MS,
+ * moves messageCount to the next epoch boundary. Call before building a frame.
+ */
+void rekeyIfDue(NodeState *peer);
+
+// Directions precomputeKeystreams fills (KeystreamCache.h)
+#define KEYSTREAM_SEND 0x01    // Next counter we send under (TX: MSG)
+#define KEYSTREAM_RECEIVE 0x02 // Next counter the peer sends under (RX: MSG)
+
+/**
+ * Idle-time work: fills at most one keystream cache entry for the next frame of an
+ * authenticated peer, covering the first LORA_KEYSTREAM_CACHE_PEERS of them so that
+ * more peers than slots cannot thrash the cache. Returns true if it did any work.
+ */
+bool precomputeKeystreams(uint8_t directions);
+
+/**
+ * 32-bit value from the auth key, used to answer challenges (CHAL, RESUME).
+ */
+uint32_t authToken(const NodeState *peer);
+
+// Log formatting: public keys as carried in PK payloads, the send key in hex.
+// There is deliberately no formatter for the private key.
+String remotePublicKeyString(const NodeState *peer);
+String sessionKeyString(const NodeState *peer);
+
+#endif
@@ -0,0 +1,219 @@
+#include "SessionTicket.h"
+#include <EEPROM.h>
+#include "BinaryFrame.h"
+#include "ChaCha20.h"
+#include "ChaChaPoly.h"
+
+#define TICKET_HEADER_LEN 8
+// send, receive and auth keys, then sendEpoch, receiveEpoch, sharedSessionKey, counter limit
+#define TICKET_BODY_LEN (3 * SESSION_KEY_SIZE + 4 * 4)
+
+static_assert(TICKET_HEADER_LEN + TICKET_BODY_LEN + AEAD_TAG_SIZE <= SESSION_TICKET_SIZE, "ticket slot too small");
+
+static int slotAddress(uint8_t slot)
+{
+    return SESSION_TICKET_BASE_ADDR + slot * SESSION_TICKET_SIZE;
+}
+
+static void putU32(uint8_t *p, uint32_t v)
+{
+    for (uint8_t i = 0; i < 4; i++)
+        p[i] = (v >> (8 * i)) & 0xFF;
+}
+
+static uint32_t getU32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+// Storage key: one ChaCha20 block keyed by the device seed. It keeps session keys out of a
+// plain EEPROM dump and rejects corrupted slots; it is no stronger than the seed itself.
+static void ticketKey(uint32_t seed, uint8_t key[CHACHA20_KEY_SIZE])
+{
+    static const uint8_t label[CHACHA20_NONCE_SIZE] = {'s', 'e', 's', 's', 'i', 'o', 'n', '-', 't', 'k', 't', 0};
+    uint8_t seedKey[CHACHA20_KEY_SIZE] = {0};
+    putU32(seedKey, seed);
+
+    uint32_t block[16];
+    chacha20Block(seedKey, label, 0, block);
+    memcpy(key, block, CHACHA20_KEY_SIZE);
+    memset(block, 0, sizeof(block));
+}
+
+static void ticketNonce(uint32_t generation, uint8_t nonce[CHACHA20_NONCE_SIZE])
+{
+    memset(nonce, 0, CHACHA20_NONCE_SIZE);
+    putU32(nonce, generation);
+}
+
+static void readSlot(uint8_t slot, uint8_t *out)
+{
+    for (uint8_t i = 0; i < SESSION_TICKET_SIZE; i++)
+        out[i] = EEPROM.read(slotAddress(slot) + i);
+}
+
+static bool isSlotUsed(uint8_t slot)
+{
+    return EEPROM.read(slotAddress(slot)) == SESSION_TICKET_MAGIC;
+}
+
+static uint16_t slotPeer(uint8_t slot)
+{
+    int base = slotAddress(slot);
+    return ((uint16_t)EEPROM.read(base + 2) << 8) | EEPROM.read(base + 3);
+}
+
+// Slot holding this peer, else a free slot, else the oldest ticket
+static uint8_t chooseSlot(uint16_t peerAddress)
+{
+    int8_t freeSlot = -1;
+    uint8_t oldestSlot = 0;
+    uint32_t oldestGeneration = 0xFFFFFFFF;
+
+    for (uint8_t slot = 0; slot < SESSION_TICKET_SLOTS; slot++)
+    {
+        if (!isSlotUsed(slot))
+        {
+            if (freeSlot < 0)
+                freeSlot = slot;
+            continue;
+        }
+        if (slotPeer(slot) == peerAddress)
+            return slot;
+
+        uint32_t generation;
+        EEPROM.get(slotAddress(slot) + 4, generation);
+        if (generation < oldestGeneration)
+        {
+            oldestGeneration = generation;
+            oldestSlot = slot;
+        }
+    }
+    return freeSlot >= 0 ? freeSlot : oldestSlot;
+}
+
+bool saveSessionTicket(NodeState *peer, uint32_t seed)
+{
+    uint16_t address = peer->address;
+    if (peer->sharedSessionKey == 0 || peer->nameSlot != PEER_NO_NAME) // Tickets store compact addresses
+        return false;
+
+    uint32_t generation;
+    EEPROM.get(SESSION_TICKET_GENERATION_ADDR, generation);
+    if (generation == 0xFFFFFFFF) // Erased EEPROM
+        generation = 0;
+    generation++;
+    EEPROM.put(SESSION_TICKET_GENERATION_ADDR, generation);
+
+    uint32_t counterLimit = peer->messageCount + SESSION_TICKET_COUNTER_STRIDE;
+
+    uint8_t slot[SESSION_TICKET_SIZE] = {0};
+    slot[0] = SESSION_TICKET_MAGIC;
+    slot[1] = SESSION_TICKET_VERSION;
+    slot[2] = address >> 8;
+    slot[3] = address & 0xFF;
+    putU32(slot + 4, generation);
+
+    // The current chain keys, not the DH secret: a stolen ticket cannot decrypt older epochs
+    uint8_t body[TICKET_BODY_LEN];
+    uint8_t *fields = body + 3 * SESSION_KEY_SIZE;
+    memcpy(body, peer->sendKey, SESSION_KEY_SIZE);
+    memcpy(body + SESSION_KEY_SIZE, peer->receiveKey, SESSION_KEY_SIZE);
+    memcpy(body + 2 * SESSION_KEY_SIZE, peer->authKey, SESSION_KEY_SIZE);
+    putU32(fields, peer->sendEpoch);
+    putU32(fields + 4, peer->receiveEpoch);
+    putU32(fields + 8, peer->sharedSessionKey);
+    putU32(fields + 12, counterLimit);
+
+    uint8_t key[CHACHA20_KEY_SIZE];
+    uint8_t nonce[CHACHA20_NONCE_SIZE];
+    ticketKey(seed, key);
+    ticketNonce(generation, nonce);
+    aeadEncrypt(key, nonce, slot, TICKET_HEADER_LEN, body, slot + TICKET_HEADER_LEN, TICKET_BODY_LEN,
+                slot + TICKET_HEADER_LEN + TICKET_BODY_LEN);
+
+    int base = slotAddress(chooseSlot(address));
+    for (uint8_t i = 0; i < SESSION_TICKET_SIZE; i++)
+        EEPROM.update(base + i, slot[i]);
+
+    memset(key, 0, sizeof(key));
+    memset(body, 0, sizeof(body));
+    peer->ticketCounterLimit = counterLimit;
+    return true;
+}
+
+void refreshSessionTicket(NodeState *peer, uint32_t seed)
+{
+    if (peer->ticketCounterLimit != 0 && peer->messageCount >= peer->ticketCounterLimit)
+        saveSessionTicket(peer, seed);
+}
+
+void eraseSessionTicket(const String &peerId)
+{
+    uint16_t address = encodeNodeAddress(peerId);
+    for (uint8_t slot = 0; slot < SESSION_TICKET_SLOTS; slot++)
+    {
+        if (isSlotUsed(slot) && slotPeer(slot) == address)
+            EEPROM.update(slotAddress(slot), 0);
+    }
+}
+
+uint8_t loadSessionTickets(uint32_t seed)
+{
+    uint8_t key[CHACHA20_KEY_SIZE];
+    ticketKey(seed, key);
+    uint8_t restored = 0;
+
+    for (uint8_t slot = 0; slot < SESSION_TICKET_SLOTS; slot++)
+    {
+        uint8_t raw[SESSION_TICKET_SIZE];
+        readSlot(slot, raw);
+        if (raw[0] != SESSION_TICKET_MAGIC || raw[1] != SESSION_TICKET_VERSION)
+            continue;
+
+        uint8_t nonce[CHACHA20_NONCE_SIZE];
+        uint8_t body[TICKET_BODY_LEN];
+        ticketNonce(getU32(raw + 4), nonce);
+        if (!aeadDecrypt(key, nonce, raw, TICKET_HEADER_LEN, raw + TICKET_HEADER_LEN, body, TICKET_BODY_LEN,
+                         raw + TICKET_HEADER_LEN + TICKET_BODY_LEN))
+        {
+            Serial.println("⚠️  Session ticket in slot " + String(slot) + " failed authentication. Discarding.");
+            EEPROM.update(slotAddress(slot), 0);
+            continue;
+        }
+
+        NodeState *peer = findOrCreatePeer(decodeNodeAddress(((uint16_t)raw[2] << 8) | raw[3]));
+        if (!peer)
+            continue;
+        resetPeer(peer);
+        const uint8_t *fields = body + 3 * SESSION_KEY_SIZE;
+        memcpy(peer->sendKey, body, SESSION_KEY_SIZE);
+        memcpy(peer->receiveKey, body + SESSION_KEY_SIZE, SESSION_KEY_SIZE);
+        memcpy(peer->authKey, body + 2 * SESSION_KEY_SIZE, SESSION_KEY_SIZE);
+        peer->sendEpoch = getU32(fields);
+        peer->receiveEpoch = getU32(fields + 4);
+        peer->sharedSessionKey = getU32(fields + 8);
+        peer->messageCount = getU32(fields + 12);
+        peer->sendEpochStartedAt = millis();
+        peer->ticketCounterLimit = peer->messageCount;
+
+        // Everything below the high-water mark may have been seen before the reboot
+        if (peer->messageCount > 0)
+        {
+            peer->replayHighest = peer->messageCount - 1;
+            peer->replayWindow = ~0ULL;
+        }
+        peer->pkSent = peer->pkReceived = peer->ackSent = peer->ackReceived = true;
+        peer->state = PeerState::RESUMING;
+        memset(body, 0, sizeof(body));
+
+        // Reserve the next counter window before anything is sent under the restored key
+        saveSessionTicket(peer, seed);
+
+        Serial.println("🎫 Restored session ticket for " + peerId(peer) + " (counter " + String(peer->messageCount) + ")");
+        restored++;
+    }
+
+    memset(key, 0, sizeof(key));
+    return restored;
+}
@@ -0,0 +1,48 @@
+#ifndef SESSION_TICKET_H
+#define SESSION_TICKET_H
+
+#include <Arduino.h>
+#include "LoRaConfig.h"
+#include "NodeManager.h"
+
+// ========== EEPROM layout ==========
+// 0..19  device ID (EEPROMWriter.h)
+// 20..23 seed      (EEPROMWriter.h)
+// 24..27 ticket write generation (nonce source, never reused)
+// 32..   SESSION_TICKET_SLOTS tickets of SESSION_TICKET_SIZE bytes:
+//        [magic][version][peer addr:2][generation:4][sealed keys, epochs, counter:112][tag:16]
+#define SESSION_TICKET_GENERATION_ADDR 24
+#define SESSION_TICKET_BASE_ADDR 32
+#define SESSION_TICKET_SLOTS 4
+#define SESSION_TICKET_SIZE 136
+#define SESSION_TICKET_MAGIC 0x5E
+#define SESSION_TICKET_VERSION 2 // 1 held the pre-key-schedule session key
+
+// Counter values reserved per ticket write. A resumed session continues at the reserved
+// limit, so a nonce is never reused after a reboot; EEPROM is rewritten once per stride.
+#define SESSION_TICKET_COUNTER_STRIDE 64
+
+/**
+ * Seals the peer's traffic keys and a new counter high-water mark into its EEPROM slot.
+ * The ticket key is derived from the device seed. Returns false if the peer has no
+ * session key or its ID has no compact address (those sessions are not resumable).
+ */
+bool saveSessionTicket(NodeState *peer, uint32_t seed);
+
+/**
+ * Re-saves the ticket once the peer's counter reaches the reserved high-water mark.
+ */
+void refreshSessionTicket(NodeState *peer, uint32_t seed);
+
+/**
+ * Invalidates the ticket stored for this peer, if any.
+ */
+void eraseSessionTicket(const String &peerId);
+
+/**
+ * Restores every ticket that authenticates under the device seed as a peer in RESUMING
+ * state. Returns the number of peers restored.
+ */
+uint8_t loadSessionTickets(uint32_t seed);
+
+#endif
@@ -0,0 +1,145 @@
+#include "DedupCache.h"
+
+// Age is kept in ~1 s ticks (millis / 1024) so an entry fits in 12 bytes. The sweep runs
+// every tick and expiry is well under 256 ticks, so the 8-bit stamp never wraps.
+#define DEDUP_TICK_SHIFT 10
+#define DEDUP_EXPIRY_TICKS ((LORA_DEDUP_EXPIRY_MS >> DEDUP_TICK_SHIFT) + 1)
+
+static_assert(DEDUP_EXPIRY_TICKS < 200, "LORA_DEDUP_EXPIRY_MS must be under about 200 s");
+
+struct DedupEntry
+{
+    uint32_t messageCount;
+    uint16_t sender;
+    uint16_t receiver;
+    MessageType type;
+    uint8_t lowestTtl; // 0 = free slot (frames are only recorded with TTL > 0)
+    uint8_t stamp;     // Tick of the last copy heard
+};
+
+static DedupEntry entries[DEDUP_SLOTS];
+static uint8_t lastSweepTick = 0;
+static DedupStats stats = {0, 0, 0, 0};
+
+static uint8_t tickOf(unsigned long now)
+{
+    return (uint8_t)(now >> DEDUP_TICK_SHIFT);
+}
+
+static uint16_t homeSlot(MessageType type, uint16_t sender, uint16_t receiver, uint32_t messageCount)
+{
+    uint32_t hash = ((messageCount + (uint32_t)type) * 2654435761UL) ^ ((uint32_t)sender << 16 | receiver) * 40503UL;
+    return (uint16_t)(hash ^ (hash >> 15)) & (DEDUP_SLOTS - 1);
+}
+
+static DedupEntry *find(MessageType type, uint16_t sender, uint16_t receiver, uint32_t messageCount)
+{
+    uint16_t slot = homeSlot(type, sender, receiver, messageCount);
+    for (uint8_t probe = 0; probe < DEDUP_PROBE_WINDOW; probe++)
+    {
+        DedupEntry &entry = entries[slot];
+        if (entry.lowestTtl != 0 && entry.messageCount == messageCount && entry.type == type &&
+            entry.sender == sender && entry.receiver == receiver)
+        {
+            return &entry;
+        }
+        slot = (slot + 1) & (DEDUP_SLOTS - 1);
+    }
+    return nullptr;
+}
+
+// Free slot in the key's window, else its least recently heard entry
+static DedupEntry *slotFor(MessageType type, uint16_t sender, uint16_t receiver, uint32_t messageCount, uint8_t tick)
+{
+    uint16_t slot = homeSlot(type, sender, receiver, messageCount);
+    DedupEntry *oldest = &entries[slot];
+    for (uint8_t probe = 0; probe < DEDUP_PROBE_WINDOW; probe++)
+    {
+        DedupEntry &entry = entries[slot];
+        if (entry.lowestTtl == 0)
+            return &entry;
+        if ((uint8_t)(tick - entry.stamp) > (uint8_t)(tick - oldest->stamp))
+            oldest = &entry;
+        slot = (slot + 1) & (DEDUP_SLOTS - 1);
+    }
+    stats.replaced++;
+    return oldest;
+}
+
+int recordTtlSeen(MessageType type, uint16_t sender, uint16_t receiver, uint32_t messageCount, int ttl, unsigned long now)
+{
+    uint8_t heard = ttl > 255 ? 255 : (uint8_t)ttl;
+    uint8_t tick = tickOf(now);
+    stats.lookups++;
+
+    DedupEntry *entry = find(type, sender, receiver, messageCount);
+    if (entry)
+    {
+        int previous = entry->lowestTtl;
+        if (heard < entry->lowestTtl)
+            entry->lowestTtl = heard;
+        entry->stamp = tick;
+        stats.duplicates++;
+        return previous;
+    }
+
+    entry = slotFor(type, sender, receiver, messageCount, tick);
+    entry->messageCount = messageCount;
+    entry->type = type;
+    entry->sender = sender;
+    entry->receiver = receiver;
+    entry->lowestTtl = heard;
+    entry->stamp = tick;
+    return DEDUP_NOT_SEEN;
+}
+
+int lowestTtlSeen(MessageType type, uint16_t sender, uint16_t receiver, uint32_t messageCount)
+{
+    const DedupEntry *entry = find(type, sender, receiver, messageCount);
+    return entry ? entry->lowestTtl : DEDUP_NOT_SEEN;
+}
+
+bool isRepeatedFrame(const LoRaMessageView &view, unsigned long now)
+{
+    if (!view.valid || view.ttl <= 0 || view.sender == NODE_ADDR_INVALID)
+        return false;
+
+    return recordTtlSeen(view.messageType, view.sender, view.receiver, view.messageCount, view.ttl, now) != DEDUP_NOT_SEEN;
+}
+
+void expireDedupEntries(unsigned long now)
+{
+    uint8_t tick = tickOf(now);
+    if (tick == lastSweepTick)
+        return;
+    lastSweepTick = tick;
+
+    uint16_t inUse = 0;
+    for (uint16_t slot = 0; slot < DEDUP_SLOTS; slot++)
+    {
+        DedupEntry &entry = entries[slot];
+        if (entry.lowestTtl == 0)
+            continue;
+        if ((uint8_t)(tick - entry.stamp) > DEDUP_EXPIRY_TICKS)
+            entry.lowestTtl = 0;
+        else
+            inUse++;
+    }
+    stats.inUse = inUse;
+}
+
+const DedupStats &dedupStats()
+{
+    return stats;
+}
+
+void printDedupStats()
+{
+    Serial.println("\n========= Duplicate Cache =========");
+    Serial.println("🗂️  Entries: " + String(stats.inUse) + "/" + String(DEDUP_SLOTS) +
+                   " (" + String((unsigned long)sizeof(entries)) + " bytes)");
+    Serial.println("🔍 Lookups: " + String(stats.lookups));
+    Serial.println("♊ Duplicates: " + String(stats.duplicates));
+    Serial.println("♻️  Replaced Before Expiry: " + String(stats.replaced));
+    Serial.println("===================================\n");
+}
@@ -0,0 +1,58 @@
+#ifndef DEDUP_CACHE_H
+#define DEDUP_CACHE_H
+
+#include <Arduino.h>
+#include "LoRaConfig.h"
+#include "MessageType.h"
+#include "MessageView.h"
+
+// ========== Relay duplicate cache ==========
+// Lowest TTL heard per message, keyed on (type, sender, receiver, counter): counters are per
+// link, so the receiver is part of the key, and control frames number themselves
+// independently of MSG/CHAL/RESP, so the type is too. Open addressing with a bounded probe window:
+// lookups compare at most DEDUP_PROBE_WINDOW slots, and an insert into a full window
+// replaces its oldest entry. Entries expire after LORA_DEDUP_EXPIRY_MS, so a sender that
+// restarts its counters is not mistaken for a duplicate. Fixed size, no heap.
+
+#define DEDUP_SLOTS LORA_DEDUP_SLOTS
+#define DEDUP_PROBE_WINDOW 8
+#define DEDUP_NOT_SEEN -1
+
+static_assert((DEDUP_SLOTS & (DEDUP_SLOTS - 1)) == 0 && DEDUP_SLOTS >= DEDUP_PROBE_WINDOW,
+              "LORA_DEDUP_SLOTS must be a power of two of at least 8");
+
+struct DedupStats
+{
+    uint32_t lookups;    // Frames checked
+    uint32_t duplicates; // Frames already seen (not relayed again)
+    uint32_t replaced;   // Live entries pushed out before expiring (history too short)
+    uint16_t inUse;      // Live entries after the last expiry sweep
+};
+
+/**
+ * Records a heard copy of a message and keeps the lowest TTL. Returns the lowest TTL
+ * heard before this copy, or DEDUP_NOT_SEEN if the message is new.
+ */
+int recordTtlSeen(MessageType type, uint16_t sender, uint16_t receiver, uint32_t messageCount, int ttl, unsigned long now);
+
+/**
+ * Lowest TTL heard for a message, or DEDUP_NOT_SEEN.
+ */
+int lowestTtlSeen(MessageType type, uint16_t sender, uint16_t receiver, uint32_t messageCount);
+
+/**
+ * Records a received frame at an end node and returns true if a copy was already heard,
+ * e.g. directly and again through a relay. Frames without TTL are never repeats.
+ */
+bool isRepeatedFrame(const LoRaMessageView &view, unsigned long now);
+
+/**
+ * Frees entries older than LORA_DEDUP_EXPIRY_MS. Call from the loop; it only scans the
+ * table about once a second.
+ */
+void expireDedupEntries(unsigned long now);
+
+const DedupStats &dedupStats();
+void printDedupStats();
+
+#endif
@@ -0,0 +1,28 @@
+#include "RelayBackoff.h"
+
+static uint8_t scale(float value, float floor, float ceiling)
+{
+    if (value <= floor)
+        return 0;
+    if (value >= ceiling)
+        return 255;
+    return (uint8_t)((value - floor) * 255.0f / (ceiling - floor));
+}
+
+uint8_t linkQuality(int16_t rssi, float snr)
+{
+    uint16_t snrScore = scale(snr, RELAY_SNR_FLOOR_DB, RELAY_SNR_CEILING_DB);
+    uint16_t rssiScore = scale(rssi, RELAY_RSSI_FLOOR_DBM, RELAY_RSSI_CEILING_DBM);
+    return (snrScore + rssiScore) / 2;
+}
+
+unsigned long relayBackoff(int16_t rssi, float snr)
+{
+#if LORA_RELAY_BACKOFF == RELAY_BACKOFF_SNR
+    // Quality picks the slot; the jitter separates relays that hear the sender equally well
+    const unsigned long span = LORA_RELAY_BACKOFF_MAX_MS - LORA_RELAY_BACKOFF_MIN_MS - LORA_RELAY_BACKOFF_JITTER_MS;
+    return LORA_RELAY_BACKOFF_MIN_MS + span * linkQuality(rssi, snr) / 255 + random(0, LORA_RELAY_BACKOFF_JITTER_MS);
+#else
+    return random(LORA_RELAY_BACKOFF_MIN_MS, LORA_RELAY_BACKOFF_MAX_MS);
+#endif
+}
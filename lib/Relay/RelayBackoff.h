@@ -0,0 +1,34 @@
+#ifndef RELAY_BACKOFF_H
+#define RELAY_BACKOFF_H
+
+#include <Arduino.h>
+#include "LoRaConfig.h"
+
+// ========== Relay contention backoff ==========
+// How long a relay waits before forwarding a frame. With LORA_RELAY_BACKOFF_SNR the wait
+// grows with the link quality of the received copy: relays at the edge of the sender's
+// range forward first and extend coverage the most, while relays close to the sender
+// overhear them and cancel (cancelRelay).
+
+#define RELAY_BACKOFF_RANDOM 0 // Uniform in [MIN, MAX) regardless of the link
+#define RELAY_BACKOFF_SNR 1    // Weighted by SNR and RSSI of the received copy
+
+// Demodulation floor of the configured spreading factor: -7.5 dB at SF7, 2.5 dB lower per step
+#define RELAY_SNR_FLOOR_DB (-7.5f - 2.5f * (LORA_SPREADING_FACTOR - 7))
+#define RELAY_SNR_CEILING_DB 10.0f // SX127x SNR readings saturate around here
+#define RELAY_RSSI_FLOOR_DBM -120
+#define RELAY_RSSI_CEILING_DBM -50
+
+/**
+ * Link quality of a received copy, 0 (at the demodulation floor) to 255 (strong).
+ * Mean of the normalised SNR and RSSI: SNR separates weak links, RSSI keeps separating
+ * strong ones once SNR saturates.
+ */
+uint8_t linkQuality(int16_t rssi, float snr);
+
+/**
+ * Backoff in ms for a frame received with this RSSI/SNR, per LORA_RELAY_BACKOFF.
+ */
+unsigned long relayBackoff(int16_t rssi, float snr);
+
+#endif
@@ -0,0 +1,186 @@
+#include "RelayQueue.h"
+#include "AggregateFrame.h"
+
+static PendingRelay slots[RELAY_QUEUE_SLOTS];
+static bool used[RELAY_QUEUE_SLOTS] = {false};
+static uint8_t order[RELAY_QUEUE_SLOTS]; // Queued slot indices, earliest sendTime first
+static uint8_t depth = 0;
+static RelayQueueStats stats = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+
+// Wrap-safe: true if a is due before b
+static bool isEarlier(unsigned long a, unsigned long b)
+{
+    return (long)(a - b) < 0;
+}
+
+static uint8_t slotIndex(const PendingRelay *entry)
+{
+    return entry - slots;
+}
+
+PendingRelay *reserveRelaySlot()
+{
+    for (uint8_t i = 0; i < RELAY_QUEUE_SLOTS; i++)
+    {
+        if (!used[i])
+        {
+            used[i] = true;
+            return &slots[i];
+        }
+    }
+    stats.droppedFull++;
+    return nullptr;
+}
+
+void commitRelay(PendingRelay *entry)
+{
+    // Insertion sort on the index array; equal deadlines keep arrival order
+    uint8_t position = depth;
+    while (position > 0 && isEarlier(entry->sendTime, slots[order[position - 1]].sendTime))
+    {
+        order[position] = order[position - 1];
+        position--;
+    }
+    order[position] = slotIndex(entry);
+    depth++;
+
+    stats.queued++;
+    stats.prepareMicros += entry->prepareMicros;
+    if (depth > stats.highWater)
+        stats.highWater = depth;
+}
+
+PendingRelay *nextDueRelay(unsigned long now)
+{
+    if (depth == 0 || isEarlier(now, slots[order[0]].sendTime))
+        return nullptr;
+    return &slots[order[0]];
+}
+
+// Frees a slot: reserved-only slots are not in `order`
+static void freeSlot(uint8_t index)
+{
+    for (uint8_t position = 0; position < depth; position++)
+    {
+        if (order[position] == index)
+        {
+            memmove(&order[position], &order[position + 1], depth - position - 1);
+            depth--;
+            break;
+        }
+    }
+    used[index] = false;
+}
+
+void releaseRelay(PendingRelay *entry, bool sent)
+{
+    if (sent)
+    {
+        stats.relayed++;
+        stats.relayedQuality += entry->quality;
+    }
+    freeSlot(slotIndex(entry));
+}
+
+// Small sensor frames gain the most; control frames keep their own backoff
+static bool isAggregatable(const PendingRelay &entry, const PendingRelay &head)
+{
+    return entry.type == MessageType::MSG && entry.receiver == head.receiver;
+}
+
+size_t packRelayAggregate(PendingRelay *head, unsigned long until, uint8_t *out, size_t capacity, uint8_t &packed)
+{
+    packed = 0;
+    if (!isAggregatable(*head, *head))
+        return 0;
+
+    size_t length = beginAggregateFrame(out, capacity);
+    length = appendAggregateFrame(out, length, capacity, head->packet, head->packetLength);
+    if (length == 0)
+        return 0;
+
+    uint8_t members[RELAY_QUEUE_SLOTS];
+    uint8_t count = 0;
+    members[count++] = slotIndex(head);
+
+    // `order` is sorted, so the scan stops at the first frame due after `until`
+    for (uint8_t position = 0; position < depth && !isEarlier(until, slots[order[position]].sendTime); position++)
+    {
+        const PendingRelay &entry = slots[order[position]];
+        if (&entry == head || !isAggregatable(entry, *head))
+            continue;
+
+        size_t grown = appendAggregateFrame(out, length, capacity, entry.packet, entry.packetLength);
+        if (grown == 0)
+            continue; // A smaller frame further on may still fit
+        length = grown;
+        members[count++] = order[position];
+    }
+
+    if (count < 2)
+        return 0;
+
+    for (uint8_t i = 0; i < count; i++)
+        releaseRelay(&slots[members[i]], true);
+
+    stats.aggregates++;
+    stats.aggregatedFrames += count;
+    packed = count;
+    return length;
+}
+
+uint8_t cancelRelay(MessageType type, uint16_t sender, uint16_t receiver, uint32_t messageCount, int overheardTtl)
+{
+    uint8_t cancelled = 0;
+    uint8_t position = 0;
+    while (position < depth)
+    {
+        const PendingRelay &entry = slots[order[position]];
+        if (entry.sender == sender && entry.receiver == receiver && entry.messageCount == messageCount &&
+            entry.type == type && entry.ttl >= overheardTtl)
+        {
+            stats.cancelledQuality += entry.quality;
+            freeSlot(order[position]); // Shifts the next entry into `position`
+            cancelled++;
+        }
+        else
+        {
+            position++;
+        }
+    }
+    stats.cancelled += cancelled;
+    return cancelled;
+}
+
+uint8_t relayQueueDepth()
+{
+    return depth;
+}
+
+const RelayQueueStats &relayQueueStats()
+{
+    return stats;
+}
+
+void printRelayQueueStats()
+{
+    Serial.println("\n========= Relay Queue =========");
+    Serial.println("📦 Depth: " + String(depth) + "/" + String(RELAY_QUEUE_SLOTS) + " (high water " + String(stats.highWater) + ")");
+    Serial.println("📥 Queued: " + String(stats.queued));
+    if (stats.queued > 0)
+        Serial.println("⏱ Mean Forward Prep: " + String(stats.prepareMicros / stats.queued) + " us");
+    Serial.println("🔁 Relayed: " + String(stats.relayed));
+    Serial.println("⏸ Cancelled (overheard): " + String(stats.cancelled));
+    uint32_t decided = stats.relayed + stats.cancelled;
+    if (decided > 0)
+    {
+        Serial.println("📉 Suppression Rate: " + String(stats.cancelled * 100UL / decided) + "%");
+        Serial.println("📶 Mean Link Quality (relayed/cancelled): " +
+                       String(stats.relayed ? stats.relayedQuality / stats.relayed : 0UL) + "/" +
+                       String(stats.cancelled ? stats.cancelledQuality / stats.cancelled : 0UL));
+    }
+    Serial.println("🚫 Dropped (queue full): " + String(stats.droppedFull));
+    if (stats.aggregates > 0)
+        Serial.println("🧺 Aggregates: " + String(stats.aggregates) + " (" + String(stats.aggregatedFrames) + " frames)");
+    Serial.println("===============================\n");
+}
@@ -0,0 +1,88 @@
+#ifndef RELAY_QUEUE_H
+#define RELAY_QUEUE_H
+
+#include <Arduino.h>
+#include "LoRaConfig.h"
+#include "MessageType.h"
+
+// ========== Relay queue ==========
+// Frames waiting for their randomized relay backoff, sent earliest sendTime first.
+// Entries never move (the send order is kept in a separate index array), so a frame is
+// encoded straight into its slot. Fixed size, no heap.
+
+#define RELAY_QUEUE_SLOTS LORA_RELAY_QUEUE_SLOTS
+
+static_assert(RELAY_QUEUE_SLOTS > 0 && RELAY_QUEUE_SLOTS < 256, "LORA_RELAY_QUEUE_SLOTS must be 1..255");
+
+struct PendingRelay
+{
+    uint16_t sender;   // Compact node addresses (see BinaryFrame.h)
+    uint16_t receiver;
+    uint32_t messageCount;
+    int ttl;         // TTL in the queued frame (one less than received)
+    uint8_t quality; // linkQuality of the received copy (RelayBackoff.h)
+    MessageType type;
+    uint16_t prepareMicros; // Time taken to copy and rewrite the received frame into packet
+    uint8_t packet[LORA_MAX_FRAME_LEN];
+    size_t packetLength;
+    unsigned long sendTime;
+};
+
+struct RelayQueueStats
+{
+    uint32_t queued;      // Frames scheduled for relay
+    uint32_t relayed;     // Frames sent
+    uint32_t cancelled;   // Queued frames dropped because another node sent that hop first
+    uint32_t droppedFull; // Frames not queued because every slot was taken
+    uint16_t highWater;   // Most frames queued at once
+    uint32_t relayedQuality;   // Sums of linkQuality, for the mean per outcome
+    uint32_t cancelledQuality;
+    uint32_t prepareMicros; // Sum of PendingRelay::prepareMicros over queued frames
+    uint32_t aggregates;       // Aggregate frames sent (LORA_RELAY_AGGREGATION)
+    uint32_t aggregatedFrames; // Frames sent inside them (also counted in relayed)
+};
+
+/**
+ * Free slot for a frame to relay, or nullptr if the queue is full (the new
+ * frame is dropped; frames already queued keep their place). The slot becomes part of
+ * the queue only after commitRelay.
+ */
+PendingRelay *reserveRelaySlot();
+
+/**
+ * Queues a slot filled after reserveRelaySlot, ordered by entry->sendTime.
+ */
+void commitRelay(PendingRelay *entry);
+
+/**
+ * Earliest queued frame if its sendTime has passed, else nullptr. The caller sends it
+ * and then calls releaseRelay.
+ */
+PendingRelay *nextDueRelay(unsigned long now);
+
+/**
+ * Removes a queued frame and frees its slot. `sent` selects the relayed counter.
+ */
+void releaseRelay(PendingRelay *entry, bool sent);
+
+/**
+ * Packs `head` and the queued MSG frames for the same receiver due by `until` into one
+ * aggregate frame (AggregateFrame.h) in `out`, and releases every packed frame as relayed.
+ * Frames that no longer fit are left queued. Returns the aggregate length and sets
+ * `packed`, or returns 0 and leaves the queue untouched if no second frame qualifies.
+ */
+size_t packRelayAggregate(PendingRelay *head, unsigned long until, uint8_t *out, size_t capacity, uint8_t &packed);
+
+/**
+ * Drops queued copies of a message whose TTL is at or above the one just overheard:
+ * another node already sent the same hop or a later one, so ours would only repeat it.
+ * A higher overheard TTL is an earlier hop (e.g. the source again) and cancels nothing.
+ * Returns the number dropped.
+ */
+uint8_t cancelRelay(MessageType type, uint16_t sender, uint16_t receiver, uint32_t messageCount, int overheardTtl);
+
+uint8_t relayQueueDepth();
+const RelayQueueStats &relayQueueStats();
+void printRelayQueueStats();
+
+#endif
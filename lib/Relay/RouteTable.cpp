@@ -0,0 +1,137 @@
+#include "RouteTable.h"
+#include "RelayBackoff.h"
+
+extern String id;
+
+static RouteEntry routes[ROUTE_SLOTS];
+static uint8_t routeCount = 0;
+static RouteStats stats = {0, 0, 0, 0, 0};
+
+static uint16_t selfAddress()
+{
+    return encodeNodeAddress(id);
+}
+
+static bool isFresh(const RouteEntry &route, unsigned long now)
+{
+    return now - route.updatedAt < LORA_ROUTE_EXPIRY_MS;
+}
+
+static RouteEntry *findRoute(uint16_t destination)
+{
+    for (uint8_t i = 0; i < routeCount; i++)
+    {
+        if (routes[i].destination == destination)
+            return &routes[i];
+    }
+    return nullptr;
+}
+
+// Free slot, else the least recently updated route
+static RouteEntry *allocateRoute(unsigned long now)
+{
+    if (routeCount < ROUTE_SLOTS)
+        return &routes[routeCount++];
+
+    RouteEntry *oldest = &routes[0];
+    for (uint8_t i = 1; i < ROUTE_SLOTS; i++)
+    {
+        if (now - routes[i].updatedAt > now - oldest->updatedAt)
+            oldest = &routes[i];
+    }
+    return oldest;
+}
+
+void learnRoute(const LoRaMessageView &view, const LoRaFrame &frame, unsigned long now)
+{
+    if (!view.valid || view.sender == NODE_ADDR_INVALID || view.sender == NODE_ADDR_BROADCAST)
+        return;
+
+    // Frames with TTL 0 are never relayed, so they came straight from the sender
+    uint16_t hop = view.ttl == 0 ? view.sender : view.hop;
+    if (hop == NODE_ADDR_INVALID || view.sender == selfAddress())
+        return;
+
+    uint8_t quality = linkQuality(frame.rssi, frame.snr);
+    if (quality < LORA_ROUTE_MIN_QUALITY)
+        return;
+
+    uint8_t ttl = hop == view.sender ? ROUTE_DIRECT_TTL : (uint8_t)view.ttl;
+    RouteEntry *route = findRoute(view.sender);
+
+    if (route && isFresh(*route, now) && route->nextHop != hop)
+    {
+        // Keep the current next hop unless the new one is closer, or as close and clearly stronger
+        bool closer = ttl > route->ttl;
+        bool stronger = ttl == route->ttl && quality > route->quality + 32;
+        if (!closer && !stronger)
+            return;
+    }
+
+    if (!route)
+        route = allocateRoute(now);
+    if (route->destination != view.sender || route->nextHop != hop)
+        stats.learned++;
+    else if (ttl < route->ttl && isFresh(*route, now))
+        ttl = route->ttl; // Same path: keep its best metric
+
+    route->destination = view.sender;
+    route->nextHop = hop;
+    route->ttl = ttl;
+    route->quality = quality;
+    route->updatedAt = now;
+}
+
+uint16_t nextHopFor(uint16_t destination, unsigned long now)
+{
+    RouteEntry *route = findRoute(destination);
+    if (!route)
+        return NODE_ADDR_BROADCAST;
+    if (!isFresh(*route, now))
+    {
+        stats.expired++;
+        return NODE_ADDR_BROADCAST;
+    }
+    return route->nextHop;
+}
+
+FrameRoute outgoingRoute(uint16_t destination, unsigned long now)
+{
+    FrameRoute route = {selfAddress(), nextHopFor(destination, now)};
+    if (route.via == NODE_ADDR_BROADCAST)
+        stats.flooded++;
+    else
+        stats.unicast++;
+    return route;
+}
+
+bool isDesignatedRelay(const LoRaMessageView &view)
+{
+    if (view.via == NODE_ADDR_BROADCAST || view.via == selfAddress())
+        return true;
+
+    stats.notDesignated++;
+    return false;
+}
+
+const RouteStats &routeStats()
+{
+    return stats;
+}
+
+void printRouteTable(unsigned long now)
+{
+    Serial.println("\n========= Routes =========");
+    for (uint8_t i = 0; i < routeCount; i++)
+    {
+        const RouteEntry &route = routes[i];
+        Serial.print("🧭 " + decodeNodeAddress(route.destination) + " via " + decodeNodeAddress(route.nextHop));
+        Serial.print(route.ttl == ROUTE_DIRECT_TTL ? String(" (direct") : " (TTL " + String(route.ttl));
+        Serial.print(", quality " + String(route.quality) + ", " + String((now - route.updatedAt) / 1000) + " s old");
+        Serial.println(isFresh(route, now) ? ")" : ", stale)");
+    }
+    Serial.println("📚 Learned: " + String(stats.learned) + " | ⌛ Expired Lookups: " + String(stats.expired));
+    Serial.println("🎯 Unicast: " + String(stats.unicast) + " | 🌊 Flooded: " + String(stats.flooded) +
+                   " | 🙈 Not Designated: " + String(stats.notDesignated));
+    Serial.println("==========================\n");
+}
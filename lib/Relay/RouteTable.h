@@ -0,0 +1,63 @@
+#ifndef ROUTE_TABLE_H
+#define ROUTE_TABLE_H
+
+#include <Arduino.h>
+#include "LoRaConfig.h"
+#include "LoRaReceive.h"
+#include "MessageView.h"
+#include "BinaryFrame.h"
+
+// ========== Reverse-path routes (LORA_ROUTING) ==========
+// Every node learns, from the frames it hears, which neighbour last transmitted a frame
+// from each sender (FrameRoute.hop) and keeps the best one as the next hop towards that
+// sender. Routed frames name their designated relay in FrameRoute.via; other relays drop
+// them. A destination without a fresh route is flooded as before. Fixed size, no heap.
+
+#define ROUTE_SLOTS LORA_ROUTE_SLOTS
+#define ROUTE_DIRECT_TTL 0xFF // Metric of a sender heard directly (beats any relayed path)
+
+struct RouteEntry
+{
+    uint16_t destination;
+    uint16_t nextHop;
+    uint8_t ttl;     // Highest remaining TTL seen through nextHop (more = fewer hops)
+    uint8_t quality; // linkQuality of nextHop (RelayBackoff.h)
+    unsigned long updatedAt;
+};
+
+struct RouteStats
+{
+    uint32_t learned;       // New or changed routes
+    uint32_t expired;       // Lookups that found a route older than LORA_ROUTE_EXPIRY_MS
+    uint32_t unicast;       // Frames sent to a designated next hop
+    uint32_t flooded;       // Frames sent to ALL relays (no fresh route)
+    uint32_t notDesignated; // Routed frames a relay heard but left to another relay
+};
+
+/**
+ * Learns the route back to a received frame's sender. The transmitter is the frame's hop
+ * field, or the sender itself for frames that cannot be relayed (TTL 0). Links weaker
+ * than LORA_ROUTE_MIN_QUALITY are ignored.
+ */
+void learnRoute(const LoRaMessageView &view, const LoRaFrame &frame, unsigned long now);
+
+/**
+ * Fresh next hop towards destination, or NODE_ADDR_BROADCAST.
+ */
+uint16_t nextHopFor(uint16_t destination, unsigned long now);
+
+/**
+ * Routing fields for a frame this node transmits towards destination. Counts it as
+ * unicast or flooded.
+ */
+FrameRoute outgoingRoute(uint16_t destination, unsigned long now);
+
+/**
+ * True if this relay should forward the frame: it is flooded or names this node as via.
+ */
+bool isDesignatedRelay(const LoRaMessageView &view);
+
+const RouteStats &routeStats();
+void printRouteTable(unsigned long now);
+
+#endif
@@ -2,8 +2,17 @@
 #include <LoRa.h>
 #include "LoRaConfig.h"
 #include "LoRaSetup.h"
+#include "LoRaReceive.h"
 #include "EEPROMReader.h"
 #include "MessageUtils.h"
+#include "MessageTransport.h"
+#include "RelayQueue.h"
+#include "DedupCache.h"
+#include "RelayBackoff.h"
+#include "AggregateFrame.h"
+#if LORA_ROUTING
+#include "RouteTable.h"
+#endif
 
 // -------------------------------
 // Device and Message Identity
@@ -12,91 +21,7 @@
 String id;
 uint32_t seed;
 
-// -------------------------------
-// Seen message memory (per TTL)
-// -------------------------------
-
-struct SeenMessage
-{
-    String senderId;
-    uint32_t messageCount;
-    int ttl;
-};
-
-#define MAX_SEEN 30
-SeenMessage seenMessages[MAX_SEEN];
-int seenIndex = 0;
-
-bool isDuplicate(String senderId, uint32_t msgCount, int ttl)
-{
-    for (int i = 0; i < MAX_SEEN; i++)
-    {
-        if (seenMessages[i].senderId == senderId &&
-            seenMessages[i].messageCount == msgCount &&
-            seenMessages[i].ttl == ttl)
-        {
-            return true;
-        }
-    }
-    return false;
-}
-
-void markMessageSeen(String senderId, uint32_t msgCount, int ttl)
-{
-    seenMessages[seenIndex] = {senderId, msgCount, ttl};
-    seenIndex = (seenIndex + 1) % MAX_SEEN;
-}
-
-// -------------------------------
-// Track relayed TTLs (used to cancel others)
-// -------------------------------
-
-struct SeenTTL
-{
-    String senderId;
-    uint32_t messageCount;
-    int ttl;
-};
-
-#define MAX_SEEN_TTL 30
-SeenTTL seenLowerTTLs[MAX_SEEN_TTL];
-int seenTTLIndex = 0;
-
-bool hasSeenLowerTTL(String senderId, uint32_t msgCount, int ttl)
-{
-    for (int i = 0; i < MAX_SEEN_TTL; i++)
-    {
-        if (seenLowerTTLs[i].senderId == senderId &&
-            seenLowerTTLs[i].messageCount == msgCount &&
-            seenLowerTTLs[i].ttl == ttl)
-        {
-            return true;
-        }
-    }
-    return false;
-}
-
-void markLowerTTLSeen(String senderId, uint32_t msgCount, int ttl)
-{
-    seenLowerTTLs[seenTTLIndex] = {senderId, msgCount, ttl};
-    seenTTLIndex = (seenTTLIndex + 1) % MAX_SEEN_TTL;
-}
-
-// -------------------------------
-// Pending relay
-// -------------------------------
-
-struct PendingRelay
-{
-    String senderId;
-    uint32_t messageCount;
-    int ttl;
-    String packet;
-    unsigned long sendTime;
-    bool valid;
-};
-
-PendingRelay pending;
+LoRaFrame rxFrame; // Preallocated receive buffer
 
 // -------------------------------
 // Utility: Time formatting
@@ -144,108 +69,197 @@ void setup()
 }
 
 // -------------------------------
-// Arduino Loop
+// Relay decision for one received frame
+// (rxFrame holds the RSSI/SNR of the packet it arrived in)
 // -------------------------------
 
-void loop()
+void relayFrame(const uint8_t *frame, size_t length)
 {
     unsigned long now = millis();
 
-    // 1. Check and possibly send pending relay
-    if (pending.valid && now >= pending.sendTime)
+    // Parsed in place: dedup and drop decisions never touch the heap
+    LoRaMessageView msg;
+    parseMessageView(frame, length, msg);
+#if LORA_ROUTING
+    learnRoute(msg, rxFrame, now);
+#endif
+
+    // Unparsed frames and senders without a compact address cannot be tracked, so they
+    // are neither recorded nor relayed
+    if (msg.valid && msg.sender != NODE_ADDR_INVALID && msg.ttl > 0)
     {
-        // Only send if we have NOT seen the TTL-1 version already
-        if (!hasSeenLowerTTL(pending.senderId, pending.messageCount, pending.ttl))
+        // Each message is relayed at most once. A copy heard again means another node
+        // already sent that hop (or a later one), so our queued copy is suppressed.
+        if (recordTtlSeen(msg.messageType, msg.sender, msg.receiver, msg.messageCount, msg.ttl, now) != DEDUP_NOT_SEEN)
         {
-            LoRa.beginPacket();
-            LoRa.print(pending.packet);
-            LoRa.endPacket();
+            if (cancelRelay(msg.messageType, msg.sender, msg.receiver, msg.messageCount, msg.ttl) > 0)
+            {
+                Serial.print("[");
+                Serial.print(currentTime());
+                Serial.print("] ⏸ Skipped redundant relay from ");
+                Serial.print(decodeNodeAddress(msg.sender));
+                Serial.print(" | TTL=");
+                Serial.print(msg.ttl);
+                Serial.print(" | msgCount=");
+                Serial.println(msg.messageCount);
+            }
+            return;
+        }
 
-            Serial.print("[");
-            Serial.print(currentTime());
-            Serial.print("] 🔁 Relayed from ");
-            Serial.print(pending.senderId);
-            Serial.print(" | TTL=");
-            Serial.print(pending.ttl);
-            Serial.print(" | msgCount=");
-            Serial.println(pending.messageCount);
+#if LORA_ROUTING
+        // A frame with a learned route is forwarded only by the relay it names
+        if (!isDesignatedRelay(msg))
+            return;
+#endif
+
+        // Prepare next TTL packet
+        int newTTL = msg.ttl - 1;
+
+        if (newTTL > 0)
+        {
+            PendingRelay *entry = reserveRelaySlot();
+            if (!entry)
+            {
+                Serial.print("[");
+                Serial.print(currentTime());
+                Serial.print("] 🚫 Relay queue full, dropped msgCount=");
+                Serial.print(msg.messageCount);
+                Serial.print(" from ");
+                Serial.println(decodeNodeAddress(msg.sender));
+                return;
+            }
+
+            // Forward the received bytes as they are; only TTL (and hop/via) change
+            unsigned long prepareStart = micros();
+            memcpy(entry->packet, frame, length);
+#if LORA_ROUTING
+            FrameRoute route = outgoingRoute(msg.receiver, now);
+            entry->packetLength = rewriteRelayFields(entry->packet, length, sizeof(entry->packet), newTTL, &route);
+#else
+            entry->packetLength = rewriteRelayFields(entry->packet, length, sizeof(entry->packet), newTTL);
+#endif
+            entry->prepareMicros = micros() - prepareStart;
+
+            if (entry->packetLength == 0)
+            {
+                releaseRelay(entry, false);
+                return;
+            }
+
+            // Schedule it
+            entry->sender = msg.sender;
+            entry->receiver = msg.receiver;
+            entry->type = msg.messageType;
+            entry->messageCount = msg.messageCount;
+            entry->ttl = newTTL;
+            entry->quality = linkQuality(rxFrame.rssi, rxFrame.snr);
+            entry->sendTime = now + relayBackoff(rxFrame.rssi, rxFrame.snr);
+#if LORA_ROUTING
+            // The designated relay has no competitor to wait for
+            if (msg.via != NODE_ADDR_BROADCAST)
+                entry->sendTime = now + random(0, LORA_RELAY_BACKOFF_JITTER_MS);
+#endif
+            commitRelay(entry);
         }
         else
         {
             Serial.print("[");
             Serial.print(currentTime());
-            Serial.print("] ⏸ Skipped redundant relay from ");
-            Serial.print(pending.senderId);
-            Serial.print(" | TTL=");
-            Serial.print(pending.ttl);
-            Serial.print(" | msgCount=");
-            Serial.println(pending.messageCount);
+            Serial.print("] ⏹ TTL expired for msgCount=");
+            Serial.print(msg.messageCount);
+            Serial.print(" from ");
+            Serial.println(decodeNodeAddress(msg.sender));
         }
-
-        pending.valid = false;
     }
+}
 
-    // 2. Listen for LoRa messages
-    if (LoRa.parsePacket())
-    {
-        String received = "";
-        while (LoRa.available())
-            received += (char)LoRa.read();
+#if LORA_RELAY_AGGREGATION
+// -------------------------------
+// Sends `due` together with queued MSG frames for the same receiver that fall due within
+// the aggregation window. Returns false if there were none (`due` is still queued).
+// -------------------------------
 
-        LoRaMessage msg = parseMessageWithTTL(received);
+bool sendAggregate(PendingRelay *due, unsigned long now)
+{
+    uint8_t aggregate[LORA_MAX_FRAME_LEN];
+    uint8_t packed = 0;
+    uint16_t receiver = due->receiver;
+    size_t length = packRelayAggregate(due, now + LORA_RELAY_AGGREGATE_WINDOW_MS, aggregate, sizeof(aggregate), packed);
+    if (length == 0)
+        return false;
+
+    sendFrame(aggregate, length);
+
+    Serial.print("[");
+    Serial.print(currentTime());
+    Serial.print("] 🧺 Relayed ");
+    Serial.print(packed);
+    Serial.print(" frames for ");
+    Serial.print(decodeNodeAddress(receiver));
+    Serial.print(" in one aggregate | ");
+    Serial.print(length);
+    Serial.print(" bytes | queued=");
+    Serial.println(relayQueueDepth());
+    return true;
+}
+#endif
 
-        // Track what TTLs we hear for suppression
-        markLowerTTLSeen(msg.senderId, msg.messageCount, msg.ttl);
+// -------------------------------
+// Arduino Loop
+// -------------------------------
 
-        if (msg.type != "INVALID" && msg.ttl > 0)
+void loop()
+{
+    // Serial commands from the dashboard
+    if (Serial.available())
+    {
+        String input = Serial.readStringUntil('\n');
+        input.trim();
+        if (input == "RELAY")
         {
-            if (isDuplicate(msg.senderId, msg.messageCount, msg.ttl))
-            {
-                // Cancel if we already scheduled this
-                if (pending.valid &&
-                    pending.senderId == msg.senderId &&
-                    pending.messageCount == msg.messageCount &&
-                    pending.ttl == msg.ttl)
-                {
-                    pending.valid = false;
-                }
-                return;
-            }
-
-            // Mark this TTL level as seen
-            markMessageSeen(msg.senderId, msg.messageCount, msg.ttl);
+            printRelayQueueStats();
+            printDedupStats();
+        }
+        else if (input == "RADIO")
+        {
+            printReceiveStats();
+        }
+#if LORA_ROUTING
+        else if (input == "ROUTES")
+        {
+            printRouteTable(millis());
+        }
+#endif
+    }
 
-            // Prepare next TTL packet
-            int newTTL = msg.ttl - 1;
+    unsigned long now = millis();
 
-            if (newTTL > 0)
-            {
-                String relayed = createMessageWithTTL(
-                    msg.type,
-                    msg.senderId,
-                    msg.receiverId,
-                    newTTL,
-                    msg.messageCount,
-                    msg.payload);
-
-                // Schedule it
-                pending = {
-                    msg.senderId,
-                    msg.messageCount,
-                    newTTL,
-                    relayed,
-                    now + random(300, 1000),
-                    true};
-            }
-            else
-            {
-                Serial.print("[");
-                Serial.print(currentTime());
-                Serial.print("] ⏹ TTL expired for msgCount=");
-                Serial.print(msg.messageCount);
-                Serial.print(" from ");
-                Serial.println(msg.senderId);
-            }
-        }
+    // 1. Send the earliest queued relay once its backoff has passed
+    expireDedupEntries(now);
+    PendingRelay *due = nextDueRelay(now);
+#if LORA_RELAY_AGGREGATION
+    if (due && sendAggregate(due, now))
+        due = nullptr;
+#endif
+    if (due)
+    {
+        sendFrame(due->packet, due->packetLength);
+
+        Serial.print("[");
+        Serial.print(currentTime());
+        Serial.print("] 🔁 Relayed from ");
+        Serial.print(decodeNodeAddress(due->sender));
+        Serial.print(" | TTL=");
+        Serial.print(due->ttl);
+        Serial.print(" | msgCount=");
+        Serial.print(due->messageCount);
+        Serial.print(" | queued=");
+        Serial.println(relayQueueDepth() - 1);
+
+        releaseRelay(due, true);
     }
+
+    // 2. Listen for LoRa messages; an aggregate is handled frame by frame
+    if (receiveFrame(rxFrame))
+        forEachFrame(rxFrame.data, rxFrame.length, relayFrame);
 }
@@ -6,12 +6,22 @@
 #include <LoRa.h>
 #include "LoRaConfig.h"
 #include "LoRaSetup.h"
+#include "LoRaReceive.h"
 #include "EEPROMReader.h"
 #include "EEPROMWriter.h"
 #include "MessageUtils.h"
+#include "MessageTransport.h"
 #include "NodeManager.h"
 #include "ChallengeAuth.h"
 #include "MessageHandlers.h"
+#include "KeystreamCache.h"
+#include "AggregateFrame.h"
+#if LORA_ROUTING
+#include "RouteTable.h"
+#endif
+#if LORA_CONTROL_TTL
+#include "DedupCache.h"
+#endif
 
 // -------------------------------
 // Global Variables and Constants
@@ -21,12 +31,22 @@ uint32_t ttl = 5;
 String id;
 uint32_t seed;
 
+LoRaFrame rxFrame; // Preallocated receive buffer
+
 static unsigned long lastPing = 0;
 static unsigned long lastAckRetry = 0;
 
 const unsigned long pingInterval = 4000;     // Interval for sending PINGs
 const unsigned long ackRetryInterval = 3000; // Interval for retrying ACKs
 
+static unsigned long lastIdleSweep = 0;
+const unsigned long idleSweepInterval = 10000; // Interval for evicting idle peers
+
+#if LORA_BROADCAST_PK
+static unsigned long lastAnnounce = 0;
+const unsigned long announceInterval = 2000; // Collects PONGs into one PK broadcast
+#endif
+
 // -------------------------------
 // Utility Functions
 // -------------------------------
@@ -51,13 +71,34 @@ String currentTime()
 void broadcastClear()
 {
     String clearMsg = createMessage("CLEAR", id, "ALL", "RESET");
-    LoRa.beginPacket();
-    LoRa.print(clearMsg);
-    LoRa.endPacket();
+    sendMessage("CLEAR", id, "ALL", "RESET");
     Serial.println("STEP 1: 📢 Broadcasted CLEAR to ALL peers");
     Serial.println("[ " + clearMsg + " ]");
 }
 
+/**
+ * Parses and dispatches one received frame (a whole packet or one frame of an aggregate).
+ * rxFrame holds the RSSI/SNR of the packet it arrived in.
+ */
+void handleFrame(const uint8_t *frame, size_t length)
+{
+    // Parse in place; malformed and unknown frames are dropped before anything is allocated
+    LoRaMessageView view;
+    parseMessageView(frame, length, view);
+#if LORA_ROUTING
+    learnRoute(view, rxFrame, millis());
+#endif
+
+#if LORA_CONTROL_TTL
+    // Frames can now arrive both directly and through relays; handle the first copy only
+    if (isRepeatedFrame(view, millis()))
+        return;
+#endif
+
+    // ✉️ Dispatch through the RX handler table
+    dispatchMessage(view, rxMessageHandlers);
+}
+
 // -------------------------------
 // Arduino Setup Routine
 // -------------------------------
@@ -85,7 +126,16 @@ void setup()
     Serial.println("Seed: " + String(seed));
     Serial.println("===================================\n");
 
-    delay(500);       // Let LoRa settle
+    delay(500); // Let LoRa settle
+
+#if LORA_SESSION_RESUMPTION
+    // Restored sessions resume with one round trip; a CLEAR would make peers drop them
+    if (loadSessionTickets(seed) > 0)
+    {
+        startSessionResumption(id, ttl);
+        return;
+    }
+#endif
     broadcastClear(); // Clear network state
 }
 
@@ -106,6 +156,28 @@ void loop()
             uint32_t seed = loadSeedFromEEPROM();
             Serial.println("ID:" + id + ",SEED:" + String(seed));
         }
+        else if (input == "AIRTIME")
+        {
+            printAirtimeComparison(id, peers.empty() ? String("ALL") : peerId(&*peers.begin()), ttl);
+        }
+        else if (input == "KEYSTREAM")
+        {
+            printKeystreamCacheStats();
+        }
+        else if (input == "PEERS")
+        {
+            printPeerTableStatus();
+        }
+        else if (input == "RADIO")
+        {
+            printReceiveStats();
+        }
+#if LORA_ROUTING
+        else if (input == "ROUTES")
+        {
+            printRouteTable(millis());
+        }
+#endif
         else if (input.startsWith("WRITE_INFO:"))
         {
             String payload = input.substring(String("WRITE_INFO:").length());
@@ -129,6 +201,18 @@ void loop()
     }
 
     unsigned long now = millis();
+
+#if LORA_CONTROL_TTL
+    // Age out duplicate entries every iteration, as the relay does: their 8-bit stamps
+    // only stay unambiguous with a sweep about once a second, frames or not
+    expireDedupEntries(now);
+#endif
+
+#if LORA_SESSION_RESUMPTION
+    // 🎫 Retry or give up on pending session resumptions
+    checkResumeTimeouts(id, ttl);
+#endif
+
     // 🔁 Retry ACKs for peers who may have missed it
     if (now - lastAckRetry >= ackRetryInterval)
     {
@@ -136,92 +220,50 @@ void loop()
         {
             if (peer.pkReceived && peer.state == PeerState::SECURE_COMM)
             {
-                String ack = createMessage("ACK", id, peer.id, "OK");
-                LoRa.beginPacket();
-                LoRa.print(ack);
-                LoRa.endPacket();
-                Serial.println("🔁 Retried ACK to " + peer.id);
+                sendMessage("ACK", id, peerId(&peer), "OK");
+                Serial.println("🔁 Retried ACK to " + peerId(&peer));
             }
         }
         lastAckRetry = now;
     }
 
+    // 🧹 Drop unauthenticated peers that went quiet
+    if (now - lastIdleSweep >= idleSweepInterval)
+    {
+        evictIdlePeers();
+        lastIdleSweep = now;
+    }
+
+#if LORA_FAST_HANDSHAKE
+    // ⚡ Resend or give up on unanswered KX_INITs
+    retryFastHandshakes();
+#endif
+
+#if LORA_BROADCAST_PK
+    // 📣 One PK broadcast covers every peer discovered since the last one
+    if (now - lastAnnounce >= announceInterval)
+    {
+        announcePublicKey();
+        lastAnnounce = now;
+    }
+#endif
+
     // 📡 Periodically broadcast PING to discover peers
     if (now - lastPing >= pingInterval)
     {
-        String pingMsg = createMessage("PING", id, "ALL", "Who is out there?");
-        LoRa.beginPacket();
-        LoRa.print(pingMsg);
-        LoRa.endPacket();
+        sendMessage("PING", id, "ALL", "Who is out there?");
         lastPing = now;
     }
 
     // 📩 Handle received LoRa packets
-    if (LoRa.parsePacket())
+    if (receiveFrame(rxFrame))
     {
-        String received = "";
-        while (LoRa.available())
-            received += (char)LoRa.read();
-
-        LoRaMessage msg;
-        if (received.startsWith("MSG:") || received.startsWith("RESP:") || received.startsWith("CHAL:"))
-            msg = parseMessageWithTTL(received);
-        else
-            msg = parseMessage(received);
-
-        // ✉️ Dispatch to appropriate handler based on message type
-        if (msg.type == "PING")
-        {
-            handlePing(msg);
-        }
-        else if (msg.type == "PK")
-        {
-            handlePkExchange(msg, seed);
-        }
-        else if (msg.type == "ACK")
-        {
-            handleAck(msg);
-        }
-        else if (msg.type == "CLEAR")
-        {
-            handleClear(msg);
-        }
-        else if (msg.type == "MSG")
-        {
-            handleMsg(msg);
-        }
-        else if (msg.type == "PONG")
-        {
-            // ⚙️ Begin DH key exchange after receiving PONG
-            NodeState *peer = findOrCreatePeer(msg.senderId);
-            if (!peer->pkSent)
-            {
-                Serial.println(" \n======== STEP 3: Rx Initiating DH Key Exchange ========");
-                peer->privateKey = generatePrivateKey(seed);
-                peer->publicKey = generatePublicKey(peer->privateKey);
-                String pkMsg = createMessage("PK", id, msg.senderId, String(peer->publicKey));
-                LoRa.beginPacket();
-                LoRa.print(pkMsg);
-                LoRa.endPacket();
-                peer->pkSent = true;
-
-                Serial.println("PRIVATE KEY: " + String(peer->privateKey));
-                Serial.println("PUBLIC KEY: " + String(peer->publicKey));
-                Serial.println("[ " + pkMsg + " ] ");
-                Serial.println("=======================================================");
-            }
-        }
-        else if (msg.type == "CHAL")
-        {
-            // 🔐 Respond to challenge for authentication
-            NodeState *peer = findOrCreatePeer(msg.senderId);
-            handleAuthChallenge(peer, id, ttl); // Moved to modular function
-        }
-        else if (msg.type == "RESP")
-        {
-            // ✅ Verify challenge response
-            NodeState *peer = findOrCreatePeer(msg.senderId);
-            verifyAuthResponse(peer, msg.payload, msg.messageCount, id);
-        }
+        // A relay aggregate is handled frame by frame
+        forEachFrame(rxFrame.data, rxFrame.length, handleFrame);
+    }
+    else
+    {
+        // 💤 Idle: prepare the keystream for the next frame so it costs only an XOR
+        precomputeKeystreams(KEYSTREAM_RECEIVE);
     }
 }
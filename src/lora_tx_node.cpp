@@ -6,13 +6,24 @@
 #include <LoRa.h>
 #include "LoRaConfig.h"
 #include "LoRaSetup.h"
+#include "LoRaReceive.h"
 #include "EEPROMReader.h"
 #include "EEPROMWriter.h"
 #include "MessageUtils.h"
+#include "MessageTransport.h"
 #include "DHExchange.h"
 #include "NodeManager.h"
 #include "EncryptionUtils.h"
 #include "ChallengeAuth.h"
+#include "MessageHandlers.h"
+#include "KeystreamCache.h"
+#include "AggregateFrame.h"
+#if LORA_ROUTING
+#include "RouteTable.h"
+#endif
+#if LORA_CONTROL_TTL
+#include "DedupCache.h"
+#endif
 
 // -------------------------------
 // Global Variables and Constants
@@ -22,12 +33,17 @@ String id;
 uint32_t seed;
 uint32_t ttl = 5; // TTL value for messages (used in flooding or expiry control)
 
+LoRaFrame rxFrame; // Preallocated receive buffer
+
 unsigned long lastMessageSent = 0;
 const unsigned long messageInterval = 20000; // 10s between messages
 
 unsigned long lastAckRetry = 0;
 const unsigned long ackRetryInterval = 5000; // Retry ACKs every 5s
 
+unsigned long lastIdleSweep = 0;
+const unsigned long idleSweepInterval = 10000; // Evict idle peers every 10s
+
 const int lightSensorPin = A0; // Analog light sensor input
 
 // -------------------------------
@@ -39,10 +55,7 @@ const int lightSensorPin = A0; // Analog light sensor input
  */
 void resetTx(String id)
 {
-    String msg = createMessage("CLEAR", id, "ALL", "RESET");
-    LoRa.beginPacket();
-    LoRa.print(msg);
-    LoRa.endPacket();
+    sendMessage("CLEAR", id, "ALL", "RESET");
 }
 
 /**
@@ -59,6 +72,29 @@ String currentTime()
     return String(buf);
 }
 
+/**
+ * Parses and dispatches one received frame (a whole packet or one frame of an aggregate).
+ * rxFrame holds the RSSI/SNR of the packet it arrived in.
+ */
+void handleFrame(const uint8_t *frame, size_t length)
+{
+    // Parse in place; malformed and unknown frames are dropped before anything is allocated
+    LoRaMessageView view;
+    parseMessageView(frame, length, view);
+#if LORA_ROUTING
+    learnRoute(view, rxFrame, millis());
+#endif
+
+#if LORA_CONTROL_TTL
+    // Frames can now arrive both directly and through relays; handle the first copy only
+    if (isRepeatedFrame(view, millis()))
+        return;
+#endif
+
+    // ✉️ Dispatch through the TX handler table
+    dispatchMessage(view, txMessageHandlers);
+}
+
 // -------------------------------
 // Arduino Setup Routine
 // -------------------------------
@@ -79,14 +115,23 @@ void setup()
     }
 
     id = loadDeviceIdFromEEPROM();
-    uint32_t seed = loadSeedFromEEPROM();
+    seed = loadSeedFromEEPROM();
 
     Serial.println("\n============= TX NODE =============");
     Serial.println("DEVICE_ID: " + id);
     Serial.println("Seed: " + String(seed));
     Serial.println("===================================\n");
 
-    delay(100);  // Let LoRa settle
+    delay(100); // Let LoRa settle
+
+#if LORA_SESSION_RESUMPTION
+    // Restored sessions resume with one round trip; a CLEAR would make peers drop them
+    if (loadSessionTickets(seed) > 0)
+    {
+        startSessionResumption(id, ttl);
+        return;
+    }
+#endif
     resetTx(id); // Signal CLEAR to network
 }
 
@@ -108,6 +153,28 @@ void loop()
             uint32_t seed = loadSeedFromEEPROM();
             Serial.println("ID:" + id + ",SEED:" + String(seed));
         }
+        else if (input == "AIRTIME")
+        {
+            printAirtimeComparison(id, peers.empty() ? String("ALL") : peerId(&*peers.begin()), ttl);
+        }
+        else if (input == "KEYSTREAM")
+        {
+            printKeystreamCacheStats();
+        }
+        else if (input == "PEERS")
+        {
+            printPeerTableStatus();
+        }
+        else if (input == "RADIO")
+        {
+            printReceiveStats();
+        }
+#if LORA_ROUTING
+        else if (input == "ROUTES")
+        {
+            printRouteTable(millis());
+        }
+#endif
         else if (input.startsWith("WRITE_INFO:"))
         {
             String payload = input.substring(String("WRITE_INFO:").length());
@@ -132,6 +199,19 @@ void loop()
 
     unsigned long now = millis();
 
+#if LORA_CONTROL_TTL
+    // Age out duplicate entries every iteration, as the relay does: their 8-bit stamps
+    // only stay unambiguous with a sweep about once a second, frames or not
+    expireDedupEntries(now);
+#endif
+
+#if LORA_SESSION_RESUMPTION
+    // -------------------------------
+    // 🎫 Retry pending session resumptions
+    // -------------------------------
+    checkResumeTimeouts(id, ttl);
+#endif
+
     // -------------------------------
     // 🔁 Retry pending ACKs for peers
     // -------------------------------
@@ -141,16 +221,22 @@ void loop()
         {
             if (peer.pkReceived && peer.state == PeerState::ACK_PENDING)
             {
-                String ack = createMessage("ACK", id, peer.id, "OK");
-                LoRa.beginPacket();
-                LoRa.print(ack);
-                LoRa.endPacket();
-                Serial.println("🔁 Retried ACK to " + peer.id);
+                sendMessage("ACK", id, peerId(&peer), "OK");
+                Serial.println("🔁 Retried ACK to " + peerId(&peer));
             }
         }
         lastAckRetry = now;
     }
 
+    // ----------------------------------
+    // 🧹 Drop unauthenticated idle peers
+    // ----------------------------------
+    if (now - lastIdleSweep >= idleSweepInterval)
+    {
+        evictIdlePeers();
+        lastIdleSweep = now;
+    }
+
     // ----------------------------------
     // 📤 Send encrypted data to peers
     // ----------------------------------
@@ -161,13 +247,16 @@ void loop()
             if (peer.state == PeerState::AUTHENTICATED)
             {
                 String sensorReading = String(analogRead(lightSensorPin)); // Sample data
-                String encryptedPayload = encryptString(sensorReading, peer.sharedSessionKey, peer.messageCount);
-                String msg = createMessageWithTTL("MSG", id, peer.id, ttl, peer.messageCount, encryptedPayload);
+                String receiver = peerId(&peer);
+                rekeyIfDue(&peer);
+                String encryptedPayload = encryptForPeer(&peer, sensorReading, peer.messageCount,
+                                                         createAssociatedData("MSG", id, receiver, peer.messageCount));
+                String msg = createMessageWithTTL("MSG", id, receiver, ttl, peer.messageCount, encryptedPayload);
+                sendMessageWithTTL("MSG", id, receiver, ttl, peer.messageCount, encryptedPayload);
                 peer.messageCount++;
-
-                LoRa.beginPacket();
-                LoRa.print(msg);
-                LoRa.endPacket();
+#if LORA_SESSION_RESUMPTION
+                refreshSessionTicket(&peer, seed);
+#endif
 
                 Serial.println("Plain Text Message: " + sensorReading);
                 Serial.println("Encrypted Message: " + encryptedPayload);
@@ -183,159 +272,14 @@ void loop()
     // --------------------------------
     // 📩 Handle incoming LoRa packets
     // --------------------------------
-    if (LoRa.parsePacket())
+    if (receiveFrame(rxFrame))
     {
-        String received = "";
-        while (LoRa.available())
-            received += (char)LoRa.read();
-
-        LoRaMessage msg;
-        if (received.startsWith("MSG:") || received.startsWith("CHAL:") || received.startsWith("RESP:"))
-            msg = parseMessageWithTTL(received);
-        else
-            msg = parseMessage(received);
-
-        // ---------------------
-        // PING/PONG handshake
-        // ---------------------
-        if (msg.type == "PING")
-        {
-            String pong = createMessage("PONG", id, msg.senderId, "READY");
-            LoRa.beginPacket();
-            LoRa.print(pong);
-            LoRa.endPacket();
-        }
-
-        // ---------------------
-        // Diffie-Hellman Key Exchange
-        // ---------------------
-        else if (msg.type == "PK")
-        {
-            NodeState *peer = findOrCreatePeer(msg.senderId);
-
-            if (isPeerDHComplete(peer->id))
-                return;
-
-            peer->remotePublicKey = msg.payload.toInt();
-            peer->pkReceived = true;
-
-            if (peer->privateKey == 0 || peer->publicKey == 0)
-            {
-                peer->privateKey = generatePrivateKey(seed);
-                peer->publicKey = generatePublicKey(peer->privateKey);
-            }
-
-            String pkMsg = createMessage("PK", id, msg.senderId, String(peer->publicKey));
-            LoRa.beginPacket();
-            LoRa.print(pkMsg);
-            LoRa.endPacket();
-
-            Serial.println(" \n======== STEP 4: Tx -> Rx :DH Key Exchange ========");
-            Serial.println("PRIVATE KEY: " + String(peer->privateKey));
-            Serial.println("PUBLIC KEY: " + String(peer->publicKey));
-            Serial.println("[ " + pkMsg + " ] ");
-            Serial.println("=====================================================");
-
-            peer->pkSent = true;
-            peer->state = PeerState::ACK_PENDING;
-
-            // Send ACK immediately
-            String ackMsg = createMessage("ACK", id, msg.senderId, "OK");
-            LoRa.beginPacket();
-            LoRa.print(ackMsg);
-            LoRa.endPacket();
-
-            Serial.println(" \n======== Tx -> Rx :Sends Acknowledgement ========");
-            Serial.println("[ " + ackMsg + " ] ");
-            Serial.println("=====================================================");
-
-            // Derive shared session key
-            if (peer->sharedSessionKey == 0 &&
-                peer->remotePublicKey != 0 &&
-                peer->privateKey != 0 &&
-                peer->pkReceived && peer->pkSent)
-            {
-                peer->sharedSessionKey = generateSharedKey(peer->remotePublicKey, peer->privateKey);
-                Serial.println(" \n\n======== STEP 6: Tx Generates Shared Session Key ========");
-                Serial.println("SHARED SESSION KEY: " + String(peer->sharedSessionKey));
-                Serial.println("==========================================================");
-            }
-
-            markPeerAckReceived(peer->id);
-        }
-
-        // ---------------------
-        // Acknowledgement handler
-        // ---------------------
-        else if (msg.type == "ACK")
-        {
-            NodeState *peer = findOrCreatePeer(msg.senderId);
-            bool wasAckMissing = !peer->ackReceived;
-            markPeerAckReceived(peer->id);
-
-            if (peer->pkReceived && peer->state == PeerState::ACK_PENDING && wasAckMissing)
-            {
-                String ack = createMessage("ACK", id, msg.senderId, "OK");
-                LoRa.beginPacket();
-                LoRa.print(ack);
-                LoRa.endPacket();
-            }
-
-            if (peer->sharedSessionKey == 0 &&
-                peer->privateKey != 0 &&
-                peer->remotePublicKey != 0 &&
-                peer->pkSent && peer->pkReceived)
-            {
-                peer->sharedSessionKey = generateSharedKey(peer->privateKey, peer->remotePublicKey);
-            }
-
-            if (isPeerDHComplete(peer->id) && peer->state != PeerState::SECURE_COMM)
-            {
-                peer->state = PeerState::SECURE_COMM;
-                printPeerStatus();
-            }
-        }
-
-        // ---------------------
-        // CLEAR message to reset peer state
-        // ---------------------
-        else if (msg.type == "CLEAR")
-        {
-            if (msg.receiverId == "ALL" || msg.receiverId == id)
-            {
-                Serial.println("STEP 2: ⚠️  Received CLEAR from " + msg.senderId + ". Removing peer.");
-                Serial.println("[ " +
-                               msg.type + ":" +
-                               msg.senderId + ":" +
-                               msg.receiverId + ":" +
-                               msg.payload +
-                               " ] \n");
-
-                NodeState *peer = findOrCreatePeer(msg.senderId);
-                resetPeer(peer);
-            }
-        }
-
-        // ---------------------
-        // Challenge-Response: CHAL
-        // ---------------------
-        else if (msg.type == "CHAL")
-        {
-            NodeState *peer = findOrCreatePeer(msg.senderId);
-            handleChallengeResponse(peer, msg, id, ttl);
-        }
-
-        // ---------------------
-        // Authentication result
-        // ---------------------
-        else if (msg.type == "AUTH_SUCCESS")
-        {
-            NodeState *peer = findOrCreatePeer(msg.senderId);
-            if (msg.payload == "OK")
-            {
-                Serial.println("✅ Received AUTH success from " + msg.senderId);
-                peer->state = PeerState::AUTHENTICATED;
-            }
-        }
+        // A relay aggregate is handled frame by frame
+        forEachFrame(rxFrame.data, rxFrame.length, handleFrame);
+    }
+    else
+    {
+        // 💤 Idle: prepare the keystream for the next frame so it costs only an XOR
+        precomputeKeystreams(KEYSTREAM_SEND);
     }
 }
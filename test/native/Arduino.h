@@ -0,0 +1,225 @@
+#ifndef NATIVE_ARDUINO_H
+#define NATIVE_ARDUINO_H
+
+// Host stand-in for the Arduino core, used by the `native` test environment only.
+// Header-only so the test runner needs no extra sources: millis() follows a simulated
+// clock when `simClock` is set, Serial output is discarded unless `serialEcho` is set,
+// and Serial input is read from `serialInput`.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <deque>
+#include <string>
+#include <utility>
+
+class String
+{
+public:
+    std::string s;
+
+    String() {}
+    String(const char *c) : s(c ? c : "") {}
+    String(const std::string &x) : s(x) {}
+    String(char c) : s(1, c) {}
+    String(int v) : s(std::to_string(v)) {}
+    String(unsigned int v) : s(std::to_string(v)) {}
+    String(long v) : s(std::to_string(v)) {}
+    String(unsigned long v) : s(std::to_string(v)) {}
+    String(long long v) : s(std::to_string(v)) {}
+    String(unsigned long long v) : s(std::to_string(v)) {}
+    String(unsigned char v) : s(std::to_string(v)) {}
+    String(float v, int d = 2) { format(v, d); }
+    String(double v, int d = 2) { format(v, d); }
+
+    unsigned int length() const { return s.size(); }
+    const char *c_str() const { return s.c_str(); }
+    bool reserve(unsigned int n)
+    {
+        s.reserve(n);
+        return true;
+    }
+
+    String substring(unsigned a) const { return a > s.size() ? String() : String(s.substr(a)); }
+    String substring(unsigned a, unsigned b) const
+    {
+        if (a > b)
+            std::swap(a, b);
+        if (a > s.size())
+            return String();
+        return String(s.substr(a, b - a));
+    }
+    int indexOf(char c, unsigned from = 0) const { return position(s.find(c, from)); }
+    int indexOf(const String &c, unsigned from = 0) const { return position(s.find(c.s, from)); }
+    int lastIndexOf(char c) const { return position(s.rfind(c)); }
+    bool startsWith(const String &p) const { return s.compare(0, p.s.size(), p.s) == 0; }
+    bool endsWith(const String &p) const
+    {
+        return s.size() >= p.s.size() && s.compare(s.size() - p.s.size(), p.s.size(), p.s) == 0;
+    }
+    long toInt() const { return atol(s.c_str()); }
+    void trim()
+    {
+        size_t a = s.find_first_not_of(" \t\r\n");
+        if (a == std::string::npos)
+        {
+            s.clear();
+            return;
+        }
+        size_t b = s.find_last_not_of(" \t\r\n");
+        s = s.substr(a, b - a + 1);
+    }
+    void remove(unsigned i)
+    {
+        if (i < s.size())
+            s.erase(i);
+    }
+    void remove(unsigned i, unsigned n)
+    {
+        if (i < s.size())
+            s.erase(i, n);
+    }
+
+    char operator[](unsigned i) const { return i < s.size() ? s[i] : 0; }
+    char &operator[](unsigned i) { return s[i]; }
+    String &operator+=(const String &o)
+    {
+        s += o.s;
+        return *this;
+    }
+    String &operator+=(const char *o)
+    {
+        s += o;
+        return *this;
+    }
+    String &operator+=(char o)
+    {
+        s += o;
+        return *this;
+    }
+    bool operator==(const String &o) const { return s == o.s; }
+    bool operator==(const char *o) const { return s == o; }
+    bool operator!=(const String &o) const { return s != o.s; }
+    bool operator!=(const char *o) const { return s != o; }
+    bool equals(const String &o) const { return s == o.s; }
+
+private:
+    static int position(size_t p) { return p == std::string::npos ? -1 : (int)p; }
+    void format(double v, int d)
+    {
+        char buffer[64];
+        snprintf(buffer, sizeof(buffer), "%.*f", d, v);
+        s = buffer;
+    }
+};
+
+inline String operator+(const String &a, const String &b) { return String(a.s + b.s); }
+inline String operator+(const String &a, const char *b) { return String(a.s + b); }
+inline String operator+(const char *a, const String &b) { return String(a + b.s); }
+inline String operator+(const String &a, char b) { return String(a.s + b); }
+inline String operator+(const String &a, int b) { return a + String(b); }
+inline String operator+(const String &a, long b) { return a + String(b); }
+inline String operator+(const String &a, unsigned long b) { return a + String(b); }
+inline String operator+(const String &a, unsigned int b) { return a + String(b); }
+inline String operator+(const String &a, uint8_t b) { return a + String(b); }
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define A0 14
+#define INPUT 0
+#define DEC 10
+
+// Simulated time: tests set `simClock` and advance `simNow` themselves
+inline bool simClock = false;
+inline unsigned long simNow = 0;
+inline const std::chrono::steady_clock::time_point hostStart = std::chrono::steady_clock::now();
+
+inline unsigned long micros()
+{
+    if (simClock)
+        return simNow * 1000UL;
+    return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now() - hostStart)
+        .count();
+}
+
+inline unsigned long millis() { return simClock ? simNow : micros() / 1000UL; }
+
+inline void delay(unsigned long ms)
+{
+    if (simClock)
+        simNow += ms;
+}
+
+inline void delayMicroseconds(unsigned int) {}
+
+// Deterministic LCG so runs are repeatable
+inline unsigned long randomState = 1;
+inline void randomSeed(unsigned long seed) { randomState = seed; }
+inline long random(long high)
+{
+    randomState = randomState * 1103515245UL + 12345UL;
+    return high > 0 ? (long)((randomState >> 8) % (unsigned long)high) : 0;
+}
+inline long random(long low, long high) { return low + random(high - low); }
+
+inline int analogRead(int) { return (int)random(1024); }
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+inline bool serialEcho = false;
+inline std::deque<std::string> serialInput;
+
+struct NativeSerial
+{
+    void begin(long) {}
+    operator bool() const { return true; }
+    int available() { return (int)serialInput.size(); }
+    String readStringUntil(char)
+    {
+        if (serialInput.empty())
+            return String();
+        String line(serialInput.front());
+        serialInput.pop_front();
+        return line;
+    }
+
+    void print(const String &v) { write(v.s); }
+    void print(const char *v) { write(v); }
+    void print(char v) { write(std::string(1, v)); }
+    void print(int v, int = DEC) { write(std::to_string(v)); }
+    void print(unsigned int v, int = DEC) { write(std::to_string(v)); }
+    void print(long v, int = DEC) { write(std::to_string(v)); }
+    void print(unsigned long v, int = DEC) { write(std::to_string(v)); }
+    void print(unsigned char v, int = DEC) { write(std::to_string(v)); }
+    void print(double v, int digits = 2) { write(String(v, digits).s); }
+
+    template <class T>
+    void println(const T &v)
+    {
+        print(v);
+        println();
+    }
+    void println(double v, int digits)
+    {
+        print(v, digits);
+        println();
+    }
+    void println() { write("\n"); }
+
+private:
+    void write(const std::string &text)
+    {
+        if (serialEcho)
+            fputs(text.c_str(), stdout);
+    }
+};
+
+inline NativeSerial Serial;
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef NATIVE_BENCH_H
+#define NATIVE_BENCH_H
+
+// Host micro-benchmarks for the `native` test suites. Include from the single
+// test_main.cpp of a suite only: it replaces the global operator new to count heap
+// allocations. Host numbers compare two code paths; they are not Uno R4 timings, and the
+// host String (std::string) keeps short strings inline, so it allocates less than the
+// Arduino one.
+
+#include <Arduino.h>
+#include <new>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+inline unsigned long heapAllocations = 0;
+
+void *operator new(size_t size)
+{
+    heapAllocations++;
+    void *block = malloc(size ? size : 1);
+    if (!block)
+        throw std::bad_alloc();
+    return block;
+}
+
+void *operator new[](size_t size) { return operator new(size); }
+void operator delete(void *block) noexcept { free(block); }
+void operator delete[](void *block) noexcept { free(block); }
+void operator delete(void *block, size_t) noexcept { free(block); }
+void operator delete[](void *block, size_t) noexcept { free(block); }
+
+// Time stamp counter where there is one, nanoseconds elsewhere
+inline uint64_t readCycles()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+#endif
+}
+
+// Per-iteration cost of one benchmark
+struct BenchResult
+{
+    double cycles;
+    double nanos;
+    double allocations;
+};
+
+// Sink for benchmark bodies, so the compiler cannot drop the work being measured
+inline volatile uint32_t benchSink = 0;
+
+/**
+ * Runs `body` `iterations` times after a short warm-up and prints the mean cost per call.
+ */
+template <class Body>
+BenchResult runBench(const char *name, unsigned long iterations, Body body)
+{
+    for (unsigned long i = 0; i < iterations / 10 + 1; i++)
+        body();
+
+    unsigned long allocationsBefore = heapAllocations;
+    auto started = std::chrono::steady_clock::now();
+    uint64_t cyclesBefore = readCycles();
+    for (unsigned long i = 0; i < iterations; i++)
+        body();
+    uint64_t cycles = readCycles() - cyclesBefore;
+    double nanos = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now() - started)
+                       .count();
+
+    BenchResult result = {(double)cycles / iterations, nanos / iterations,
+                          (double)(heapAllocations - allocationsBefore) / iterations};
+    printf("  %-40s %9.1f cycles %9.1f ns %6.2f allocs\n", name, result.cycles, result.nanos, result.allocations);
+    return result;
+}
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef NATIVE_EEPROM_H
+#define NATIVE_EEPROM_H
+
+// Host stand-in for the Arduino EEPROM library: 8 KB of RAM (as on the Uno R4), erased to 0xFF
+
+#include <Arduino.h>
+
+class EEPROMClass
+{
+public:
+    uint8_t mem[8192];
+
+    EEPROMClass() { memset(mem, 0xFF, sizeof(mem)); }
+
+    uint8_t read(int address) { return mem[address]; }
+    void write(int address, uint8_t value) { mem[address] = value; }
+    void update(int address, uint8_t value) { mem[address] = value; }
+    template <class T>
+    T &get(int address, T &value)
+    {
+        memcpy(&value, mem + address, sizeof(T));
+        return value;
+    }
+    template <class T>
+    const T &put(int address, const T &value)
+    {
+        memcpy(mem + address, &value, sizeof(T));
+        return value;
+    }
+    uint16_t length() { return sizeof(mem); }
+};
+
+inline EEPROMClass EEPROM;
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef NATIVE_LORA_H
+#define NATIVE_LORA_H
+
+// Host stand-in for sandeepmistry/LoRa. Transmitted packets are appended to `sentFrames`.
+// Tests hand packets to the node with deliverFrame(): in receive mode with an onReceive
+// handler it runs the handler (as the DIO0 interrupt would), otherwise the packet waits
+// in `rxFrames` for parsePacket(). Only one packet fits in the radio FIFO, so a packet
+// delivered before the previous one was read overwrites it.
+
+#include <Arduino.h>
+#include <string>
+#include <vector>
+
+inline std::vector<std::string> sentFrames;
+inline std::deque<std::string> rxFrames;
+inline int rxRssi = -80;
+inline float rxSnr = 8;
+
+class LoRaClass
+{
+public:
+    void (*rxCallback)(int) = nullptr;
+    bool listening = false;
+    std::string rxcur;
+    size_t rxpos = 0;
+
+    void setPins(int, int, int) {}
+    int begin(long) { return 1; }
+    void setSpreadingFactor(int) {}
+    void setSignalBandwidth(long) {}
+    void setCodingRate4(int) {}
+    void setPreambleLength(long) {}
+
+    int beginPacket(int = 0)
+    {
+        txcur.clear();
+        listening = false;
+        return 1;
+    }
+    size_t write(const uint8_t *buffer, size_t size)
+    {
+        txcur.append((const char *)buffer, size);
+        return size;
+    }
+    int endPacket(bool = false)
+    {
+        sentFrames.push_back(txcur);
+        return 1;
+    }
+
+    int parsePacket(int = 0)
+    {
+        if (rxFrames.empty())
+            return 0;
+        rxcur = rxFrames.front();
+        rxFrames.pop_front();
+        rxpos = 0;
+        return (int)rxcur.size();
+    }
+    int available() { return (int)(rxcur.size() - rxpos); }
+    int read() { return rxpos < rxcur.size() ? (uint8_t)rxcur[rxpos++] : -1; }
+    int packetRssi() { return rxRssi; }
+    float packetSnr() { return rxSnr; }
+
+    void idle() { listening = false; }
+    void receive(int = 0) { listening = true; }
+    void onReceive(void (*callback)(int)) { rxCallback = callback; }
+
+private:
+    std::string txcur;
+};
+
+inline LoRaClass LoRa;
+
+inline void deliverFrame(const std::string &packet)
+{
+    if (LoRa.listening && LoRa.rxCallback)
+    {
+        LoRa.rxcur = packet;
+        LoRa.rxpos = 0;
+        LoRa.rxCallback((int)packet.size());
+        return;
+    }
+    rxFrames.clear();
+    rxFrames.push_back(packet);
+}
+
+#endif
@@ -0,0 +1,8 @@
+#ifndef NATIVE_SPI_H
+#define NATIVE_SPI_H
+
+// Host stand-in: the native build never touches the SPI bus
+
+#include <Arduino.h>
+
+#endif
@@ -0,0 +1,314 @@
+// Published test vectors for the crypto primitives, plus the X25519 key exchange cost and
+// ChaCha20 throughput against the legacy DH and random()-based keystream they replaced.
+//   RFC 7539 2.3.2, 2.4.2, 2.5.2, 2.8.2: ChaCha20 block, ChaCha20, Poly1305, ChaCha20-Poly1305
+//   RFC 7748 5.2, 6.1: X25519
+//   RFC 5869 A.1, A.3: HKDF-SHA256
+//   FIPS 180-2 B.1, B.2, B.3: SHA-256
+
+#include <unity.h>
+#include <Bench.h>
+#include "ChaCha20.h"
+#include "ChaChaPoly.h"
+#include "Poly1305.h"
+#include "HKDF.h"
+#include "SHA256.h"
+#include "X25519.h"
+#include "DHExchange.h"
+
+static const char sunscreen[] = "Ladies and Gentlemen of the class of '99: If I could offer you only one tip "
+                                "for the future, sunscreen would be it.";
+
+// Hex string to bytes; returns the byte count
+static size_t fromHex(const char *hex, uint8_t *out)
+{
+    size_t n = 0;
+    for (; hex[0] && hex[1]; hex += 2)
+    {
+        unsigned int value;
+        sscanf(hex, "%2x", &value);
+        out[n++] = (uint8_t)value;
+    }
+    return n;
+}
+
+static void assertHex(const char *expected, const uint8_t *actual, size_t length)
+{
+    uint8_t bytes[256];
+    TEST_ASSERT_EQUAL(length, fromHex(expected, bytes));
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(bytes, actual, length);
+}
+
+static void sequentialKey(uint8_t key[32], uint8_t first)
+{
+    for (uint8_t i = 0; i < 32; i++)
+        key[i] = first + i;
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+// ========== ChaCha20 / Poly1305 (RFC 7539) ==========
+
+void test_chacha20_block()
+{
+    uint8_t key[32], nonce[12];
+    sequentialKey(key, 0);
+    fromHex("000000090000004a00000000", nonce);
+
+    uint32_t block[16];
+    chacha20Block(key, nonce, 1, block);
+    uint8_t serialized[64];
+    for (uint8_t i = 0; i < 16; i++)
+        for (uint8_t b = 0; b < 4; b++)
+            serialized[4 * i + b] = (uint8_t)(block[i] >> (8 * b));
+
+    assertHex("10f1e7e4d13b5915500fdd1fa32071c4c7d1f4c733c068030422aa9ac3d46c4e"
+              "d2826446079faa0914c2d705d98b02a2b5129cd1de164eb9cbd083e8a2503c4e",
+              serialized, 64);
+}
+
+void test_chacha20_encryption()
+{
+    uint8_t key[32], nonce[12], out[sizeof(sunscreen)];
+    sequentialKey(key, 0);
+    fromHex("000000000000004a00000000", nonce);
+
+    size_t length = strlen(sunscreen);
+    chacha20Xor(key, nonce, 1, (const uint8_t *)sunscreen, out, length);
+    assertHex("6e2e359a2568f98041ba0728dd0d6981e97e7aec1d4360c20a27afccfd9fae0b"
+              "f91b65c5524733ab8f593dabcd62b3571639d624e65152ab8f530c359f0861d8"
+              "07ca0dbf500d6a6156a38e088a22b65e52bc514d16ccf806818ce91ab7793736"
+              "5af90bbf74a35be6b40b8eedf2785e42874d",
+              out, length);
+
+    chacha20Xor(key, nonce, 1, out, out, length);
+    TEST_ASSERT_EQUAL_MEMORY(sunscreen, out, length);
+}
+
+void test_poly1305_mac()
+{
+    uint8_t key[32], tag[16];
+    fromHex("85d6be7857556d337f4452fe42d506a80103808afb0db2fd4abff6af4149f51b", key);
+    const char *message = "Cryptographic Forum Research Group";
+
+    Poly1305 ctx;
+    poly1305Init(ctx, key);
+    poly1305Update(ctx, (const uint8_t *)message, 10); // Split across the 16-byte buffer
+    poly1305Update(ctx, (const uint8_t *)message + 10, strlen(message) - 10);
+    poly1305Finish(ctx, tag);
+    assertHex("a8061dc1305136c6c22b8baf0c0127a9", tag, 16);
+}
+
+void test_chacha20_poly1305_aead()
+{
+    uint8_t key[32], nonce[12], aad[12], out[sizeof(sunscreen)], back[sizeof(sunscreen)], tag[16];
+    sequentialKey(key, 0x80);
+    fromHex("070000004041424344454647", nonce);
+    fromHex("50515253c0c1c2c3c4c5c6c7", aad);
+
+    size_t length = strlen(sunscreen);
+    aeadEncrypt(key, nonce, aad, sizeof(aad), (const uint8_t *)sunscreen, out, length, tag);
+    assertHex("d31a8d34648e60db7b86afbc53ef7ec2a4aded51296e08fea9e2b5a736ee62d6"
+              "3dbea45e8ca9671282fafb69da92728b1a71de0a9e060b2905d6a5b67ecd3b36"
+              "92ddbd7f2d778b8c9803aee328091b58fab324e4fad675945585808b4831d7bc"
+              "3ff4def08e4b7a9de576d26586cec64b6116",
+              out, length);
+    assertHex("1ae10b594f09e26a7e902ecbd0600691", tag, 16);
+
+    TEST_ASSERT_TRUE(aeadDecrypt(key, nonce, aad, sizeof(aad), out, back, length, tag));
+    TEST_ASSERT_EQUAL_MEMORY(sunscreen, back, length);
+
+    tag[0] ^= 1;
+    TEST_ASSERT_FALSE(aeadDecrypt(key, nonce, aad, sizeof(aad), out, back, length, tag));
+}
+
+// ========== X25519 (RFC 7748) ==========
+
+void test_x25519_diffie_hellman()
+{
+    uint8_t alicePrivate[32], bobPrivate[32], alicePublic[32], bobPublic[32], aliceShared[32], bobShared[32];
+    fromHex("77076d0a7318a57d3c16c17251b26645df4c2f87ebc0992ab177fba51db92c2a", alicePrivate);
+    fromHex("5dab087e624a8a4b79e17f8b83800ee66f3bb1292618b6fd1c2f8b27ff88e0eb", bobPrivate);
+
+    x25519Base(alicePublic, alicePrivate);
+    x25519Base(bobPublic, bobPrivate);
+    assertHex("8520f0098930a754748b7ddcb43ef75a0dbf3a0d26381af4eba4a98eaa9b4e6a", alicePublic, 32);
+    assertHex("de9edb7d7b7dc1b4d35b61c2ece435373f8343c85b78674dadfc7e146f882b4f", bobPublic, 32);
+
+    x25519(aliceShared, alicePrivate, bobPublic);
+    x25519(bobShared, bobPrivate, alicePublic);
+    assertHex("4a5d9d5ba4ce2de1728e3bf480350f25e07e21c947d19e3376f09b3c1e161742", aliceShared, 32);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(aliceShared, bobShared, 32);
+}
+
+void test_x25519_iterated()
+{
+    uint8_t k[32] = {9}, u[32] = {9}, next[32];
+    for (int i = 1; i <= 1000; i++)
+    {
+        x25519(next, k, u);
+        memcpy(u, k, 32);
+        memcpy(k, next, 32);
+        if (i == 1)
+            assertHex("422c8e7a6227d7bca1350b3e2bb7279f7897b87bb6854b783c60e80311ae3079", k, 32);
+    }
+    assertHex("684cf59ba83309552800ef566f2f4d3c1c3887c49360e3875f2eb94d99532c51", k, 32);
+}
+
+// One side of a key exchange: its public key, then the shared secret from the peer's key
+void test_benchmark_x25519_key_exchange()
+{
+    uint8_t privateKey[32], remotePublic[32], publicKey[32], shared[32];
+    fromHex("77076d0a7318a57d3c16c17251b26645df4c2f87ebc0992ab177fba51db92c2a", privateKey);
+    fromHex("de9edb7d7b7dc1b4d35b61c2ece435373f8343c85b78674dadfc7e146f882b4f", remotePublic);
+
+    printf("  legacy 31-bit DH (before):\n");
+    uint32_t legacyPrivate = 0x2A5F3C71;
+    runBench("generatePublicKey", 20000, [&]
+             { benchSink += generatePublicKey(legacyPrivate++); });
+    runBench("generateSharedKey", 20000, [&]
+             { benchSink += generateSharedKey(0x1234567, legacyPrivate++); });
+
+    printf("  X25519:\n");
+    BenchResult publicCost = runBench("generatePublicKey25519", 200, [&]
+                                      {
+                                          generatePublicKey25519(privateKey, publicKey);
+                                          benchSink += publicKey[0]; });
+    BenchResult sharedCost = runBench("generateSharedKey25519", 200, [&]
+                                      {
+                                          benchSink += generateSharedKey25519(remotePublic, privateKey, shared);
+                                          benchSink += shared[0]; });
+    printf("  key exchange: %.2fM cycles per side\n", (publicCost.cycles + sharedCost.cycles) / 1e6);
+
+    assertHex("8520f0098930a754748b7ddcb43ef75a0dbf3a0d26381af4eba4a98eaa9b4e6a", publicKey, 32);
+    assertHex("4a5d9d5ba4ce2de1728e3bf480350f25e07e21c947d19e3376f09b3c1e161742", shared, 32);
+    TEST_ASSERT_EQUAL(0, (int)(publicCost.allocations * 100));
+    TEST_ASSERT_EQUAL(0, (int)(sharedCost.allocations * 100));
+}
+
+// ========== HKDF (RFC 5869) ==========
+
+void test_hkdf_basic()
+{
+    uint8_t ikm[22], salt[13], info[10], prk[32], okm[42];
+    memset(ikm, 0x0b, sizeof(ikm));
+    fromHex("000102030405060708090a0b0c", salt);
+    fromHex("f0f1f2f3f4f5f6f7f8f9", info);
+
+    hkdfExtract(salt, sizeof(salt), ikm, sizeof(ikm), prk);
+    assertHex("077709362c2e32df0ddc3f0dc47bba6390b6c73bb50f9c3122ec844ad7c2b3e5", prk, 32);
+    hkdfExpand(prk, info, sizeof(info), okm, sizeof(okm));
+    assertHex("3cb25f25faacd57a90434f64d0362f2a2d2d0a90cf1a5a4c5db02d56ecc4c5bf"
+              "34007208d5b887185865",
+              okm, sizeof(okm));
+}
+
+void test_hkdf_empty_salt_and_info()
+{
+    uint8_t ikm[22], prk[32], okm[42];
+    memset(ikm, 0x0b, sizeof(ikm));
+
+    hkdfExtract(nullptr, 0, ikm, sizeof(ikm), prk);
+    assertHex("19ef24a32c717b167f33a91d6f648bdf96596776afdb6377ac434c1c293ccb04", prk, 32);
+    hkdfExpand(prk, nullptr, 0, okm, sizeof(okm));
+    assertHex("8da4e775a563c18f715f802a063c5a31b8a11f5c5ee1879ec3454e5f3c738d2d"
+              "9d201395faa4b61a96c8",
+              okm, sizeof(okm));
+}
+
+// ========== SHA-256 (FIPS 180-2) ==========
+
+static void sha256Of(const uint8_t *data, size_t length, uint8_t digest[32])
+{
+    Sha256 ctx;
+    sha256Init(ctx);
+    sha256Update(ctx, data, length);
+    sha256Finish(ctx, digest);
+}
+
+void test_sha256_one_block()
+{
+    uint8_t digest[32];
+    sha256Of((const uint8_t *)"abc", 3, digest);
+    assertHex("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad", digest, 32);
+}
+
+void test_sha256_two_blocks()
+{
+    const char *message = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+    uint8_t digest[32];
+    sha256Of((const uint8_t *)message, strlen(message), digest);
+    assertHex("248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1", digest, 32);
+}
+
+void test_sha256_million_a()
+{
+    uint8_t chunk[1000], digest[32];
+    memset(chunk, 'a', sizeof(chunk));
+
+    Sha256 ctx;
+    sha256Init(ctx);
+    for (int i = 0; i < 1000; i++)
+        sha256Update(ctx, chunk, sizeof(chunk));
+    sha256Finish(ctx, digest);
+    assertHex("cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0", digest, 32);
+}
+
+// ========== Throughput ==========
+
+// Keystream before ChaCha20: Arduino random() seeded from key + counter
+static void randomKeystreamXor(uint32_t sessionKey, uint32_t messageCount, const uint8_t *input,
+                               uint8_t *output, size_t length)
+{
+    randomSeed(sessionKey + messageCount);
+    for (size_t i = 0; i < length; i++)
+        output[i] = input[i] ^ (uint8_t)random(0, 256);
+}
+
+void test_benchmark_chacha20_throughput()
+{
+    uint8_t key[32], nonce[12] = {0}, input[1024], output[1024];
+    sequentialKey(key, 0);
+    memset(input, 0x5A, sizeof(input));
+
+    const size_t lengths[] = {16, 64, 1024};
+    for (size_t length : lengths)
+    {
+        printf("  %u-byte payload:\n", (unsigned)length);
+        uint32_t counter = 0;
+        BenchResult before = runBench("random() keystream", 20000, [&]
+                                      { randomKeystreamXor(123456789UL, counter++, input, output, length); });
+        BenchResult after = runBench("chacha20Xor", 20000, [&]
+                                     {
+                                         nonce[0] = (uint8_t)counter++;
+                                         chacha20Xor(key, nonce, 1, input, output, length); });
+        printf("  throughput: %.3f -> %.3f bytes/cycle\n", length / before.cycles, length / after.cycles);
+
+        // No speed assertion: the old keystream was cheaper, it just was not a cipher
+        TEST_ASSERT_EQUAL(0, (int)(after.allocations * 100));
+    }
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_chacha20_block);
+    RUN_TEST(test_chacha20_encryption);
+    RUN_TEST(test_poly1305_mac);
+    RUN_TEST(test_chacha20_poly1305_aead);
+    RUN_TEST(test_x25519_diffie_hellman);
+    RUN_TEST(test_x25519_iterated);
+    RUN_TEST(test_benchmark_x25519_key_exchange);
+    RUN_TEST(test_hkdf_basic);
+    RUN_TEST(test_hkdf_empty_salt_and_info);
+    RUN_TEST(test_sha256_one_block);
+    RUN_TEST(test_sha256_two_blocks);
+    RUN_TEST(test_sha256_million_a);
+    RUN_TEST(test_benchmark_chacha20_throughput);
+    return UNITY_END();
+}
@@ -0,0 +1,128 @@
+// Message type decoding (MessageType.h): every wire name round-trips, near misses are
+// rejected, and the decode/dispatch benchmark against the code it replaced.
+
+#include <unity.h>
+#include <Bench.h>
+#include "MessageType.h"
+
+static const char *const names[] = {"PING", "PONG", "PK", "ACK", "CLEAR", "CHAL", "RESP", "MSG",
+                                    "AUTH_SUCCESS", "RESUME", "RESUMED", "KX_INIT", "KX_CONFIRM"};
+
+static MessageType decode(const char *name)
+{
+    return messageTypeFromName(name, strlen(name));
+}
+
+// Decoder before the first-byte switch: a scan over the name table
+static MessageType decodeByScan(const char *name, size_t length)
+{
+    for (uint8_t code = 1; code < MESSAGE_TYPE_COUNT; code++)
+    {
+        const char *candidate = messageTypeName((MessageType)code);
+        if (candidate[0] == name[0] && strlen(candidate) == length && memcmp(candidate, name, length) == 0)
+            return (MessageType)code;
+    }
+    return MessageType::INVALID;
+}
+
+// Dispatch before handler tables: String comparisons in handler order
+static uint8_t dispatchByStringChain(const String &type)
+{
+    if (type == "PING")
+        return 1;
+    else if (type == "PK")
+        return 2;
+    else if (type == "ACK")
+        return 3;
+    else if (type == "CLEAR")
+        return 4;
+    else if (type == "MSG")
+        return 5;
+    else if (type == "PONG")
+        return 6;
+    else if (type == "CHAL")
+        return 7;
+    else if (type == "RESP")
+        return 8;
+    return 0;
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_every_name_round_trips()
+{
+    for (uint8_t code = 1; code < MESSAGE_TYPE_COUNT; code++)
+    {
+        const char *name = messageTypeName((MessageType)code);
+        TEST_ASSERT_EQUAL(code, (uint8_t)decode(name));
+    }
+    TEST_ASSERT_EQUAL(MESSAGE_TYPE_COUNT - 1, (int)(sizeof(names) / sizeof(names[0])));
+}
+
+void test_prefixes_and_extensions_are_rejected()
+{
+    for (const char *name : names)
+    {
+        size_t length = strlen(name);
+        for (size_t cut = 0; cut < length; cut++)
+        {
+            MessageType type = messageTypeFromName(name, cut);
+            // "RESUME" is both a type and a prefix of "RESUMED"
+            TEST_ASSERT_TRUE(type == MessageType::INVALID || (cut == 6 && type == MessageType::RESUME));
+        }
+
+        char longer[16];
+        snprintf(longer, sizeof(longer), "%sX", name);
+        TEST_ASSERT_TRUE(decode(longer) == MessageType::INVALID);
+    }
+}
+
+void test_unknown_names_are_rejected()
+{
+    const char *const unknown[] = {"INVALID", "BOGUS", "msg", "PIN", "PX", "PONX", "KX_", "AUTH", "Z"};
+    for (const char *name : unknown)
+        TEST_ASSERT_TRUE(decode(name) == MessageType::INVALID);
+}
+
+void test_switch_agrees_with_table_scan()
+{
+    for (const char *name : names)
+        TEST_ASSERT_TRUE(decode(name) == decodeByScan(name, strlen(name)));
+}
+
+void test_benchmark_decode()
+{
+    static const char *const cases[] = {"RESP", "KX_CONFIRM", "BOGUS"};
+    for (const char *name : cases)
+    {
+        size_t length = strlen(name);
+        String type(name);
+        printf("  %s:\n", name);
+        BenchResult chain = runBench("String if-chain (before handler tables)", 1000000, [&]
+                                     { benchSink += dispatchByStringChain(type); });
+        BenchResult scan = runBench("name table scan", 1000000, [&]
+                                    { benchSink += (uint8_t)decodeByScan(name, length); });
+        BenchResult decoded = runBench("messageTypeFromName (first-byte switch)", 1000000, [&]
+                                       { benchSink += (uint8_t)messageTypeFromName(name, length); });
+
+        TEST_ASSERT_TRUE(decoded.nanos < chain.nanos);
+        TEST_ASSERT_TRUE(decoded.nanos <= scan.nanos * 1.1);
+    }
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_every_name_round_trips);
+    RUN_TEST(test_prefixes_and_extensions_are_rejected);
+    RUN_TEST(test_unknown_names_are_rejected);
+    RUN_TEST(test_switch_agrees_with_table_scan);
+    RUN_TEST(test_benchmark_decode);
+    return UNITY_END();
+}
@@ -0,0 +1,123 @@
+// Zero-copy frame parser (MessageView.h): field-for-field agreement with the String
+// parsers it replaced, and the allocation/cycle benchmark against them.
+
+#include <unity.h>
+#include <Bench.h>
+#include "MessageView.h"
+#include "MessageUtils.h"
+
+static const char *const sequencedFrame = "MSG:TX101:RX1101:5:42:9xu7zQ==";
+static const char *const controlFrame = "PING:RX1101:ALL:Who is out: there?";
+
+static bool parse(const char *frame, LoRaMessageView &view)
+{
+    return parseMessageView((const uint8_t *)frame, strlen(frame), view);
+}
+
+// The receive path before the view: copy the frame into a String, then split it
+static LoRaMessage parseWithString(const char *frame)
+{
+    String received = "";
+    for (size_t i = 0; frame[i]; i++)
+        received += frame[i];
+
+    if (received.startsWith("MSG:") || received.startsWith("RESP:") || received.startsWith("CHAL:"))
+        return parseMessageWithTTL(received);
+    return parseMessage(received);
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_sequenced_frame_matches_string_parser()
+{
+    LoRaMessageView view;
+    TEST_ASSERT_TRUE(parse(sequencedFrame, view));
+    LoRaMessage expected = parseWithString(sequencedFrame);
+    LoRaMessage actual = toMessage(view);
+
+    TEST_ASSERT_TRUE(view.messageType == MessageType::MSG);
+    TEST_ASSERT_EQUAL_STRING(expected.type.c_str(), actual.type.c_str());
+    TEST_ASSERT_EQUAL_STRING(expected.senderId.c_str(), actual.senderId.c_str());
+    TEST_ASSERT_EQUAL_STRING(expected.receiverId.c_str(), actual.receiverId.c_str());
+    TEST_ASSERT_EQUAL_STRING(expected.payload.c_str(), actual.payload.c_str());
+    TEST_ASSERT_EQUAL(expected.ttl, actual.ttl);
+    TEST_ASSERT_EQUAL(expected.messageCount, actual.messageCount);
+}
+
+void test_control_frame_keeps_colons_in_payload()
+{
+    LoRaMessageView view;
+    TEST_ASSERT_TRUE(parse(controlFrame, view));
+    TEST_ASSERT_TRUE(view.messageType == MessageType::PING);
+#if LORA_CONTROL_TTL == 0
+    LoRaMessage expected = parseWithString(controlFrame);
+    TEST_ASSERT_EQUAL_STRING(expected.payload.c_str(), toMessage(view).payload.c_str());
+#endif
+    TEST_ASSERT_TRUE(view.receiverId.equals("ALL"));
+}
+
+void test_truncated_frames_are_rejected()
+{
+    LoRaMessageView view;
+    TEST_ASSERT_FALSE(parse("MSG:TX101:RX1101:5", view));
+    TEST_ASSERT_FALSE(view.valid);
+    TEST_ASSERT_FALSE(parse("MSG", view));
+    TEST_ASSERT_FALSE(parse("", view));
+}
+
+void test_out_of_range_numbers_are_rejected()
+{
+    LoRaMessageView view;
+    TEST_ASSERT_FALSE(parse("MSG:TX1:RX1:5:99999999999999999999:x", view));
+    TEST_ASSERT_FALSE(parse("MSG:TX1:RX1:99999999999999999999:5:x", view));
+    TEST_ASSERT_FALSE(parse("MSG:TX1:RX1:5:4294967296:x", view));
+    TEST_ASSERT_FALSE(parse("MSG:TX1:RX1:32768:5:x", view));
+
+    TEST_ASSERT_TRUE(parse("MSG:TX1:RX1:32767:4294967295:x", view));
+    TEST_ASSERT_EQUAL(32767, view.ttl);
+    TEST_ASSERT_EQUAL_UINT32(4294967295UL, view.messageCount);
+}
+
+void test_parse_does_not_allocate()
+{
+    LoRaMessageView view;
+    unsigned long before = heapAllocations;
+    for (int i = 0; i < 100; i++)
+    {
+        parse(sequencedFrame, view);
+        parse(controlFrame, view);
+    }
+    TEST_ASSERT_EQUAL(before, heapAllocations);
+}
+
+void test_benchmark_parse()
+{
+    BenchResult before = runBench("String copy + parseMessageWithTTL", 200000, []
+                                  { benchSink += parseWithString(sequencedFrame).messageCount; });
+    BenchResult after = runBench("parseMessageView", 200000, []
+                                 {
+                                     LoRaMessageView view;
+                                     parse(sequencedFrame, view);
+                                     benchSink += view.messageCount; });
+
+    TEST_ASSERT_EQUAL(0, (int)(after.allocations * 100));
+    TEST_ASSERT_TRUE(after.nanos < before.nanos);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_sequenced_frame_matches_string_parser);
+    RUN_TEST(test_control_frame_keeps_colons_in_payload);
+    RUN_TEST(test_truncated_frames_are_rejected);
+    RUN_TEST(test_out_of_range_numbers_are_rejected);
+    RUN_TEST(test_parse_does_not_allocate);
+    RUN_TEST(test_benchmark_parse);
+    return UNITY_END();
+}
@@ -0,0 +1,137 @@
+// Legacy DH arithmetic (DHExchange.h): the Mersenne-reduction and fixed-base table paths
+// of modexp must equal plain square-and-multiply, and the benchmark against it.
+
+#include <unity.h>
+#include <Bench.h>
+#include "DHExchange.h"
+
+static const uint32_t prime = 2147483647UL; // DH_PRIME
+static const uint32_t generator = 5;        // DH_GENERATOR
+
+// modexp before the Mersenne and table paths: 64-bit division on every step
+static uint32_t plainModexp(uint32_t base, uint32_t exp, uint32_t mod)
+{
+    uint64_t result = 1;
+    uint64_t power = base % mod;
+    while (exp > 0)
+    {
+        if (exp & 1)
+            result = (result * power) % mod;
+        power = (power * power) % mod;
+        exp >>= 1;
+    }
+    return (uint32_t)(result % mod);
+}
+
+// Deterministic inputs: xorshift32
+static uint32_t nextRandom()
+{
+    static uint32_t state = 0x9E3779B9;
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_generator_table_matches_plain_modexp()
+{
+    for (int i = 0; i < 20000; i++)
+    {
+        uint32_t exp = nextRandom();
+        TEST_ASSERT_EQUAL_UINT32(plainModexp(generator, exp, prime), modexp(generator, exp, prime));
+    }
+}
+
+void test_mersenne_reduction_matches_plain_modexp()
+{
+    for (int i = 0; i < 20000; i++)
+    {
+        uint32_t base = nextRandom();
+        uint32_t exp = nextRandom();
+        TEST_ASSERT_EQUAL_UINT32(plainModexp(base, exp, prime), modexp(base, exp, prime));
+    }
+}
+
+void test_edge_operands_match_plain_modexp()
+{
+    const uint32_t bases[] = {0, 1, 2, generator, prime - 1, prime, prime + 1, 0xFFFFFFFFUL};
+    const uint32_t exps[] = {0, 1, 2, 15, 16, prime - 2, prime - 1, prime, 0xFFFFFFFFUL};
+    for (uint32_t base : bases)
+        for (uint32_t exp : exps)
+            TEST_ASSERT_EQUAL_UINT32(plainModexp(base, exp, prime), modexp(base, exp, prime));
+}
+
+void test_other_moduli_use_the_generic_path()
+{
+    for (int i = 0; i < 2000; i++)
+    {
+        uint32_t base = nextRandom();
+        uint32_t exp = nextRandom();
+        TEST_ASSERT_EQUAL_UINT32(plainModexp(base, exp, 1000003UL), modexp(base, exp, 1000003UL));
+    }
+}
+
+void test_both_sides_agree_on_the_shared_key()
+{
+    for (int i = 0; i < 200; i++)
+    {
+        uint32_t a = nextRandom() % prime;
+        uint32_t b = nextRandom() % prime;
+        TEST_ASSERT_EQUAL_UINT32(generateSharedKey(generatePublicKey(b), a),
+                                 generateSharedKey(generatePublicKey(a), b));
+    }
+}
+
+void test_benchmark_modexp()
+{
+    static uint32_t bases[1024], exps[1024];
+    for (int i = 0; i < 1024; i++)
+    {
+        bases[i] = nextRandom();
+        exps[i] = nextRandom();
+    }
+
+    unsigned int next = 0;
+    printf("  public key (5^x mod p):\n");
+    BenchResult plainPublic = runBench("plain square-and-multiply", 200000, [&]
+                                       { benchSink += plainModexp(generator, exps[next++ & 1023], prime); });
+    BenchResult tablePublic = runBench("fixed-base table", 200000, [&]
+                                       { benchSink += modexp(generator, exps[next++ & 1023], prime); });
+
+    printf("  shared key (y^x mod p):\n");
+    BenchResult plainShared = runBench("plain square-and-multiply", 200000, [&]
+                                       {
+                                           unsigned int i = next++ & 1023;
+                                           benchSink += plainModexp(bases[i], exps[i], prime); });
+    BenchResult mersenneShared = runBench("Mersenne reduction", 200000, [&]
+                                          {
+                                              unsigned int i = next++ & 1023;
+                                              benchSink += modexp(bases[i], exps[i], prime); });
+
+    TEST_ASSERT_TRUE(tablePublic.nanos < plainPublic.nanos);
+
+    // Not asserted: x86-64 divides 64-bit values in hardware, so the two are within noise
+    // on the host. The Cortex-M4 emulates that division in software, which the Mersenne
+    // fold avoids.
+    printf("  shared key: Mersenne reduction at %.2fx the plain cost\n", mersenneShared.cycles / plainShared.cycles);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_generator_table_matches_plain_modexp);
+    RUN_TEST(test_mersenne_reduction_matches_plain_modexp);
+    RUN_TEST(test_edge_operands_match_plain_modexp);
+    RUN_TEST(test_other_moduli_use_the_generic_path);
+    RUN_TEST(test_both_sides_agree_on_the_shared_key);
+    RUN_TEST(test_benchmark_modexp);
+    return UNITY_END();
+}
@@ -0,0 +1,107 @@
+// Peer table (NodeManager.h): device IDs with a compact address and IDs without one
+// ("RX001", "TXA") both pair, keep their full ID, and never alias each other.
+
+#include <unity.h>
+#include "NodeManager.h"
+
+String id;
+uint32_t ttl, seed;
+
+void setUp()
+{
+    peers.clear();
+}
+
+void tearDown()
+{
+}
+
+void test_compact_ids_round_trip()
+{
+    NodeState *peer = findOrCreatePeer("TX101");
+    TEST_ASSERT_NOT_NULL(peer);
+    TEST_ASSERT_EQUAL_HEX16(encodeNodeAddress("TX101"), peer->address);
+    TEST_ASSERT_EQUAL_STRING("TX101", peerId(peer).c_str());
+    TEST_ASSERT_TRUE(peer == findOrCreatePeer("TX101"));
+    TEST_ASSERT_TRUE(peer == peers.find(encodeNodeAddress("TX101")));
+}
+
+void test_ids_without_compact_address_keep_their_name()
+{
+    const char *const names[] = {"RX001", "TX01", "TXA", "TX100000"};
+    NodeState *created[4];
+    for (int i = 0; i < 4; i++)
+    {
+        TEST_ASSERT_EQUAL_HEX16(NODE_ADDR_INVALID, encodeNodeAddress(names[i]));
+        created[i] = findOrCreatePeer(names[i]);
+        TEST_ASSERT_NOT_NULL(created[i]);
+        TEST_ASSERT_EQUAL_STRING(names[i], peerId(created[i]).c_str());
+    }
+    for (int i = 0; i < 4; i++)
+        TEST_ASSERT_TRUE(created[i] == peers.find(names[i]));
+
+    // "RX001" and "RX1" are different devices
+    NodeState *compact = findOrCreatePeer("RX1");
+    TEST_ASSERT_NOT_NULL(compact);
+    TEST_ASSERT_TRUE(compact != created[0]);
+    TEST_ASSERT_NULL(peers.find((uint16_t)created[0]->address));
+}
+
+void test_colliding_name_hashes_stay_apart()
+{
+    // Both fold to name hash 2356
+    NodeState *first = findOrCreatePeer("TX049");
+    NodeState *second = findOrCreatePeer("TX0247");
+    TEST_ASSERT_NOT_NULL(first);
+    TEST_ASSERT_NOT_NULL(second);
+    TEST_ASSERT_TRUE(first != second);
+    TEST_ASSERT_EQUAL_HEX16(first->address, second->address);
+    TEST_ASSERT_EQUAL_STRING("TX049", peerId(first).c_str());
+    TEST_ASSERT_EQUAL_STRING("TX0247", peerId(second).c_str());
+
+    peers.remove(first);
+    TEST_ASSERT_NULL(peers.find("TX049"));
+    TEST_ASSERT_TRUE(second == peers.find("TX0247"));
+}
+
+void test_name_slots_are_limited_and_reused()
+{
+    char name[8];
+    NodeState *first = nullptr;
+    for (int i = 0; i < LORA_MAX_NAMED_PEERS; i++)
+    {
+        snprintf(name, sizeof(name), "TX0%d", i);
+        NodeState *peer = findOrCreatePeer(name);
+        TEST_ASSERT_NOT_NULL(peer);
+        if (!first)
+            first = peer;
+    }
+    uint32_t rejected = peerTableStats().rejected;
+    TEST_ASSERT_NULL(findOrCreatePeer("TXA"));
+    TEST_ASSERT_EQUAL_UINT32(rejected + 1, peerTableStats().rejected);
+    TEST_ASSERT_NOT_NULL(findOrCreatePeer("TX102")); // Compact IDs need no name slot
+
+    peers.remove(first);
+    NodeState *peer = findOrCreatePeer("TXA");
+    TEST_ASSERT_NOT_NULL(peer);
+    TEST_ASSERT_EQUAL_STRING("TXA", peerId(peer).c_str());
+}
+
+void test_broadcast_and_malformed_ids_are_rejected()
+{
+    TEST_ASSERT_NULL(findOrCreatePeer("ALL"));
+    TEST_ASSERT_NULL(findOrCreatePeer(""));
+    TEST_ASSERT_NULL(findOrCreatePeer("TX12345678901234567890"));
+    TEST_ASSERT_EQUAL(0, peers.size());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_compact_ids_round_trip);
+    RUN_TEST(test_ids_without_compact_address_keep_their_name);
+    RUN_TEST(test_colliding_name_hashes_stay_apart);
+    RUN_TEST(test_name_slots_are_limited_and_reused);
+    RUN_TEST(test_broadcast_and_malformed_ids_are_rejected);
+    return UNITY_END();
+}
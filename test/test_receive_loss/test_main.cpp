@@ -0,0 +1,177 @@
+// Receive path (LoRaReceive.h): the DIO0 receive ring keeps frames in order and counts
+// overflows, and the loss harness comparing it with polling parsePacket() once per loop.
+// Build with -DLORA_RX_RING_SLOTS=8 for the larger ring.
+
+#include <unity.h>
+#include <Bench.h>
+#include "LoRaReceive.h"
+#include <LoRa.h>
+
+static_assert(LORA_RX_INTERRUPT, "the loss harness compares polling with the interrupt ring");
+
+// Gateway under bursty traffic: bursts of back-to-back packets every 5 s. The loop spends
+// frameWorkMs per frame (decrypt + 9600-baud Serial) and every 2 s transmits for
+// transmitMs (the radio is deaf in both modes) followed by ackDelayMs as in handleAck.
+static const long airtimeMs = 60;
+static const long frameWorkMs = 100;
+static const long transmitMs = 60;
+static const long ackDelayMs = 300;
+static const long durationMs = 600000;
+
+struct LossResult
+{
+    uint32_t offered;
+    uint32_t delivered;
+    uint32_t deaf; // Arrived during a transmission
+};
+
+// Deterministic arrival jitter: xorshift32
+static uint32_t nextRandom(uint32_t &state)
+{
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+// The receive path with LORA_RX_INTERRUPT=0: one packet in the radio FIFO, read once per loop
+static bool pollFrame(LoRaFrame &frame)
+{
+    int packetSize = LoRa.parsePacket();
+    if (packetSize <= 0)
+        return false;
+    readFrame(packetSize, frame);
+    return true;
+}
+
+static LossResult simulateGateway(bool interrupt, int burst)
+{
+    // Both modes see the same arrivals
+    uint32_t jitter = 0x2545F491;
+    std::vector<long> arrivals;
+    for (long start = 1000; start < durationMs; start += 5000)
+    {
+        long at = start + nextRandom(jitter) % 1000;
+        for (int i = 0; i < burst; i++)
+            arrivals.push_back(at += airtimeMs);
+    }
+
+    rxFrames.clear();
+    if (interrupt)
+        startFrameReceiver();
+    else
+        stopFrameReceiver();
+
+    LossResult result = {(uint32_t)arrivals.size(), 0, 0};
+    size_t next = 0;
+    bool transmitting = false;
+    long now = 0;
+    auto advance = [&](long ms)
+    {
+        now += ms;
+        for (; next < arrivals.size() && arrivals[next] <= now; next++)
+        {
+            if (transmitting)
+            {
+                result.deaf++;
+                continue;
+            }
+            deliverFrame("MSG:TX1:RX1:3:" + std::to_string(arrivals[next]) + ":payload");
+        }
+    };
+
+    LoRaFrame frame;
+    long lastTransmit = 0;
+    while (now < durationMs)
+    {
+        if (now - lastTransmit >= 2000)
+        {
+            lastTransmit = now;
+            transmitting = true;
+            advance(transmitMs);
+            transmitting = false;
+            advance(ackDelayMs);
+        }
+        if (interrupt ? receiveFrame(frame) : pollFrame(frame))
+        {
+            result.delivered++;
+            advance(frameWorkMs);
+        }
+        else
+        {
+            advance(1);
+        }
+    }
+    while (interrupt ? receiveFrame(frame) : pollFrame(frame))
+        result.delivered++;
+
+    stopFrameReceiver();
+    return result;
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_ring_keeps_arrival_order()
+{
+    startFrameReceiver();
+    deliverFrame("MSG:TX1:RX1:3:1:a");
+    deliverFrame("MSG:TX1:RX1:3:2:bb");
+
+    LoRaFrame frame;
+    TEST_ASSERT_TRUE(receiveFrame(frame));
+    TEST_ASSERT_EQUAL(17, frame.length);
+    TEST_ASSERT_EQUAL_MEMORY("MSG:TX1:RX1:3:1:a", frame.data, frame.length);
+    TEST_ASSERT_TRUE(receiveFrame(frame));
+    TEST_ASSERT_EQUAL_MEMORY("MSG:TX1:RX1:3:2:bb", frame.data, frame.length);
+    TEST_ASSERT_FALSE(receiveFrame(frame));
+    stopFrameReceiver();
+}
+
+void test_full_ring_counts_overflows()
+{
+    ReceiveStats before = receiveStats();
+    startFrameReceiver();
+    for (int i = 0; i < RX_RING_SLOTS + 2; i++)
+        deliverFrame("MSG:TX1:RX1:3:" + std::to_string(i) + ":x");
+
+    LoRaFrame frame;
+    int drained = 0;
+    while (receiveFrame(frame))
+        drained++;
+    stopFrameReceiver();
+
+    TEST_ASSERT_EQUAL(RX_RING_SLOTS, drained);
+    TEST_ASSERT_EQUAL_UINT32(before.overflows + 2, receiveStats().overflows);
+    TEST_ASSERT_EQUAL(RX_RING_SLOTS, receiveStats().highWater);
+}
+
+void test_loss_polled_vs_interrupt()
+{
+    const int bursts[] = {2, 4, 8};
+    for (int burst : bursts)
+    {
+        LossResult polled = simulateGateway(false, burst);
+        LossResult ring = simulateGateway(true, burst);
+        printf("  burst of %d: delivered %.1f%% polled, %.1f%% with a ring of %d (%u offered; %u / %u lost while transmitting)\n",
+               burst, 100.0 * polled.delivered / polled.offered, 100.0 * ring.delivered / ring.offered,
+               RX_RING_SLOTS, (unsigned)ring.offered, (unsigned)polled.deaf, (unsigned)ring.deaf);
+
+        TEST_ASSERT_TRUE(ring.delivered + ring.deaf <= ring.offered);
+        TEST_ASSERT_TRUE(ring.delivered > polled.delivered);
+    }
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_ring_keeps_arrival_order);
+    RUN_TEST(test_full_ring_counts_overflows);
+    RUN_TEST(test_loss_polled_vs_interrupt);
+    return UNITY_END();
+}
@@ -0,0 +1,152 @@
+// Relay aggregation (RelayQueue.h, AggregateFrame.h): every packed frame is delivered
+// intact, and the benchmark of messages relayed per second of airtime with and without
+// aggregation. Frames use the wire format selected by LORA_BINARY_FRAMES.
+
+#include <unity.h>
+#include <Bench.h>
+#include "RelayQueue.h"
+#include "AggregateFrame.h"
+#include "MessageTransport.h"
+#include "Airtime.h"
+
+String id;
+uint32_t ttl, seed;
+
+static const unsigned long backoffSpacingMs = 60; // Queued copies fall due this far apart
+
+static uint32_t delivered;
+static uint32_t deliveredCounts;
+
+static void deliver(const uint8_t *frame, size_t length)
+{
+    LoRaMessageView view;
+    if (parseMessageView(frame, length, view))
+    {
+        delivered++;
+        deliveredCounts += view.messageCount;
+    }
+}
+
+// One sensor reading per tower, all addressed to the same receiver, as a relay queues them
+static void queueRound(uint8_t towers, uint32_t round, unsigned long start)
+{
+    for (uint8_t tower = 0; tower < towers; tower++)
+    {
+        PendingRelay *entry = reserveRelaySlot();
+        TEST_ASSERT_NOT_NULL(entry);
+        String sender = "TX" + String(101 + tower);
+        // 4-digit reading plus 16-byte tag, base64 like a real MSG
+        entry->packetLength = encodeFrame("MSG", sender, "RX1101", 2, round, "Q2xAbGlnaHQ6MTAyM3RhZ3RhZ3Rh", true,
+                                          entry->packet, sizeof(entry->packet));
+        TEST_ASSERT_TRUE(entry->packetLength > 0);
+        entry->sender = encodeNodeAddress(sender);
+        entry->receiver = encodeNodeAddress("RX1101");
+        entry->messageCount = round;
+        entry->ttl = 2;
+        entry->quality = 0;
+        entry->type = MessageType::MSG;
+        entry->prepareMicros = 0;
+        entry->sendTime = start + tower * backoffSpacingMs;
+        commitRelay(entry);
+    }
+}
+
+// Sends every queued frame as the relay loop does; returns the airtime used in microseconds
+static uint64_t drainQueue(bool aggregate, uint8_t spreadingFactor)
+{
+    uint64_t airtime = 0;
+    PendingRelay *due;
+    while ((due = nextDueRelay(0x7FFFFFFFUL)) != nullptr)
+    {
+        uint8_t packet[LORA_MAX_FRAME_LEN];
+        uint8_t packed = 0;
+        size_t length = aggregate ? packRelayAggregate(due, due->sendTime + LORA_RELAY_AGGREGATE_WINDOW_MS,
+                                                       packet, sizeof(packet), packed)
+                                  : 0;
+        if (length == 0)
+        {
+            length = due->packetLength;
+            memcpy(packet, due->packet, length);
+            releaseRelay(due, true);
+        }
+        airtime += loraTimeOnAirMicros(length, spreadingFactor);
+        forEachFrame(packet, length, deliver);
+    }
+    return airtime;
+}
+
+// Messages delivered per second of airtime over `rounds` rounds
+static double relayThroughput(uint8_t towers, bool aggregate, uint8_t spreadingFactor)
+{
+    const uint32_t rounds = 100;
+    uint64_t airtime = 0;
+    delivered = 0;
+    for (uint32_t round = 0; round < rounds; round++)
+    {
+        queueRound(towers, round, round * 5000UL);
+        airtime += drainQueue(aggregate, spreadingFactor);
+    }
+    TEST_ASSERT_EQUAL_UINT32(towers * rounds, delivered);
+    return delivered * 1e6 / airtime;
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_aggregate_delivers_every_frame()
+{
+    const RelayQueueStats before = relayQueueStats();
+    delivered = 0;
+    deliveredCounts = 0;
+    queueRound(4, 7, 0);
+    drainQueue(true, LORA_SPREADING_FACTOR);
+
+    TEST_ASSERT_EQUAL_UINT32(4, delivered);
+    TEST_ASSERT_EQUAL_UINT32(4 * 7, deliveredCounts);
+    TEST_ASSERT_EQUAL(0, relayQueueDepth());
+    TEST_ASSERT_EQUAL_UINT32(before.aggregates + 1, relayQueueStats().aggregates);
+    TEST_ASSERT_EQUAL_UINT32(before.aggregatedFrames + 4, relayQueueStats().aggregatedFrames);
+}
+
+void test_frames_outside_the_window_are_sent_alone()
+{
+    const RelayQueueStats before = relayQueueStats();
+    delivered = 0;
+    queueRound(1, 1, 0);
+    queueRound(1, 2, LORA_RELAY_AGGREGATE_WINDOW_MS + 1);
+    drainQueue(true, LORA_SPREADING_FACTOR);
+
+    TEST_ASSERT_EQUAL_UINT32(2, delivered);
+    TEST_ASSERT_EQUAL_UINT32(before.aggregates, relayQueueStats().aggregates);
+}
+
+void test_benchmark_aggregation_throughput()
+{
+    const uint8_t towerCounts[] = {2, 4};
+    const uint8_t spreadingFactors[] = {7, 12};
+    for (uint8_t towers : towerCounts)
+    {
+        for (uint8_t spreadingFactor : spreadingFactors)
+        {
+            double single = relayThroughput(towers, false, spreadingFactor);
+            double aggregated = relayThroughput(towers, true, spreadingFactor);
+            printf("  %u towers, SF%u: %.2f -> %.2f messages per second of airtime\n",
+                   towers, spreadingFactor, single, aggregated);
+            TEST_ASSERT_TRUE(aggregated > single);
+        }
+    }
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_aggregate_delivers_every_frame);
+    RUN_TEST(test_frames_outside_the_window_are_sent_alone);
+    RUN_TEST(test_benchmark_aggregation_throughput);
+    return UNITY_END();
+}
@@ -0,0 +1,82 @@
+// Relay queue suppression (RelayQueue.h): an overheard copy cancels our queued relay only
+// when it is the same hop or a later one, i.e. its TTL is at or below ours.
+
+#include <unity.h>
+#include "RelayQueue.h"
+
+static const uint16_t sender = 101;
+static const uint16_t receiver = 1101;
+
+// Queues a MSG copy as a relay that received it with TTL `ttl + 1` would
+static void queue(uint32_t messageCount, int ttl)
+{
+    PendingRelay *entry = reserveRelaySlot();
+    TEST_ASSERT_NOT_NULL(entry);
+    entry->sender = sender;
+    entry->receiver = receiver;
+    entry->messageCount = messageCount;
+    entry->ttl = ttl;
+    entry->quality = 0;
+    entry->type = MessageType::MSG;
+    entry->prepareMicros = 0;
+    entry->packetLength = 0;
+    entry->sendTime = 1000;
+    commitRelay(entry);
+}
+
+void setUp()
+{
+    PendingRelay *entry;
+    while ((entry = nextDueRelay(0xFFFFFFFFUL / 2)) != nullptr)
+        releaseRelay(entry, false);
+}
+
+void tearDown()
+{
+}
+
+void test_same_ttl_cancels()
+{
+    queue(5, 2);
+    TEST_ASSERT_EQUAL(1, cancelRelay(MessageType::MSG, sender, receiver, 5, 2));
+    TEST_ASSERT_EQUAL(0, relayQueueDepth());
+}
+
+void test_lower_overheard_ttl_cancels()
+{
+    // A node further along already relayed it again
+    queue(5, 2);
+    TEST_ASSERT_EQUAL(1, cancelRelay(MessageType::MSG, sender, receiver, 5, 1));
+    TEST_ASSERT_EQUAL(0, relayQueueDepth());
+}
+
+void test_higher_overheard_ttl_keeps_the_relay()
+{
+    // An earlier hop (e.g. the source retransmitting) has not covered ours
+    queue(5, 2);
+    TEST_ASSERT_EQUAL(0, cancelRelay(MessageType::MSG, sender, receiver, 5, 3));
+    TEST_ASSERT_EQUAL(1, relayQueueDepth());
+    TEST_ASSERT_NOT_NULL(nextDueRelay(1000));
+}
+
+void test_other_messages_are_untouched()
+{
+    queue(5, 2);
+    queue(6, 2);
+    TEST_ASSERT_EQUAL(0, cancelRelay(MessageType::MSG, sender, receiver, 7, 2));
+    TEST_ASSERT_EQUAL(0, cancelRelay(MessageType::PING, sender, receiver, 5, 2));
+    TEST_ASSERT_EQUAL(0, cancelRelay(MessageType::MSG, receiver, sender, 5, 2));
+    TEST_ASSERT_EQUAL(1, cancelRelay(MessageType::MSG, sender, receiver, 6, 1));
+    TEST_ASSERT_EQUAL(1, relayQueueDepth());
+    TEST_ASSERT_EQUAL_UINT32(5, nextDueRelay(1000)->messageCount);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_same_ttl_cancels);
+    RUN_TEST(test_lower_overheard_ttl_cancels);
+    RUN_TEST(test_higher_overheard_ttl_keeps_the_relay);
+    RUN_TEST(test_other_messages_are_untouched);
+    return UNITY_END();
+}
@@ -0,0 +1,124 @@
+// In-place relay rewrite (MessageTransport.h): rewriteRelayFields must produce the same
+// bytes as the parse + re-encode path the relay used before, and the benchmark against it.
+// Frames use the wire format selected by LORA_BINARY_FRAMES.
+
+#include <unity.h>
+#include <Bench.h>
+#include "MessageTransport.h"
+
+String id;
+uint32_t ttl, seed;
+
+static const char *const payload = "q3Jm0vX9bJk1yQ2w8sT4aLp7Cz5dEe6f"; // 24 bytes of ciphertext
+
+// A MSG frame as the relay receives it, with the route the previous hop set if `incoming`
+static size_t receivedFrame(int frameTtl, const FrameRoute *incoming, uint8_t *out)
+{
+    return encodeFrame("MSG", "TX101", "RX201", frameTtl, 4242, payload, true, out, LORA_MAX_FRAME_LEN, incoming);
+}
+
+// The relay before the in-place rewrite: parse into a LoRaMessage and encode it again
+static size_t rebuildForRelay(const uint8_t *frame, size_t length, int newTtl, const FrameRoute *route, uint8_t *out)
+{
+    LoRaMessageView view;
+    parseMessageView(frame, length, view);
+    LoRaMessage relayed = toMessage(view);
+    return encodeFrame(relayed.type, relayed.senderId, relayed.receiverId, newTtl, relayed.messageCount,
+                       relayed.payload, true, out, LORA_MAX_FRAME_LEN, route);
+}
+
+static size_t rewriteForRelay(const uint8_t *frame, size_t length, int newTtl, const FrameRoute *route, uint8_t *out)
+{
+    memcpy(out, frame, length);
+    return rewriteRelayFields(out, length, LORA_MAX_FRAME_LEN, newTtl, route);
+}
+
+static void assertRewriteMatchesRebuild(int frameTtl, const FrameRoute *incoming, const FrameRoute *outgoing)
+{
+    uint8_t received[LORA_MAX_FRAME_LEN], rebuilt[LORA_MAX_FRAME_LEN], rewritten[LORA_MAX_FRAME_LEN];
+    size_t length = receivedFrame(frameTtl, incoming, received);
+    TEST_ASSERT_TRUE(length > 0);
+
+    size_t rebuiltLength = rebuildForRelay(received, length, frameTtl - 1, outgoing, rebuilt);
+    size_t rewrittenLength = rewriteForRelay(received, length, frameTtl - 1, outgoing, rewritten);
+    TEST_ASSERT_TRUE(rewrittenLength > 0);
+    TEST_ASSERT_EQUAL(rebuiltLength, rewrittenLength);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(rebuilt, rewritten, rewrittenLength);
+
+    LoRaMessageView view;
+    TEST_ASSERT_TRUE(parseMessageView(rewritten, rewrittenLength, view));
+    TEST_ASSERT_EQUAL(frameTtl - 1, view.ttl);
+    TEST_ASSERT_EQUAL_UINT32(4242, view.messageCount);
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+void test_ttl_only_matches_rebuild()
+{
+    assertRewriteMatchesRebuild(3, nullptr, nullptr);
+    assertRewriteMatchesRebuild(10, nullptr, nullptr); // ASCII field shrinks from two digits to one
+}
+
+void test_route_insertion_matches_rebuild()
+{
+    FrameRoute outgoing = {encodeNodeAddress("RL3"), encodeNodeAddress("RX201")};
+    assertRewriteMatchesRebuild(3, nullptr, &outgoing);
+}
+
+void test_route_replacement_matches_rebuild()
+{
+    FrameRoute incoming = {encodeNodeAddress("RL12"), NODE_ADDR_BROADCAST};
+    FrameRoute outgoing = {encodeNodeAddress("RL3"), encodeNodeAddress("RX201")};
+    assertRewriteMatchesRebuild(3, &incoming, &outgoing);
+    assertRewriteMatchesRebuild(10, &incoming, &outgoing);
+}
+
+void test_frames_that_do_not_fit_are_rejected()
+{
+    uint8_t frame[LORA_MAX_FRAME_LEN];
+    FrameRoute outgoing = {encodeNodeAddress("RL3"), encodeNodeAddress("RX201")};
+    size_t length = receivedFrame(3, nullptr, frame);
+    TEST_ASSERT_EQUAL(0, rewriteRelayFields(frame, length, length, 2, &outgoing));
+
+    const char *untimed = "PING:TX1:ALL:hello";
+    memcpy(frame, untimed, strlen(untimed));
+    TEST_ASSERT_EQUAL(0, rewriteRelayFields(frame, strlen(untimed), sizeof(frame), 2));
+}
+
+void test_benchmark_relay_rewrite()
+{
+    FrameRoute incoming = {encodeNodeAddress("RL12"), NODE_ADDR_BROADCAST};
+    FrameRoute outgoing = {encodeNodeAddress("RL3"), encodeNodeAddress("RX201")};
+    static uint8_t received[LORA_MAX_FRAME_LEN], out[LORA_MAX_FRAME_LEN];
+
+    for (int routed = 0; routed < 2; routed++)
+    {
+        const FrameRoute *route = routed ? &outgoing : nullptr;
+        size_t length = receivedFrame(3, routed ? &incoming : nullptr, received);
+        printf("  %s:\n", routed ? "routed" : "unrouted");
+        BenchResult before = runBench("parse + encodeFrame (before)", 200000, [&]
+                                      { benchSink += rebuildForRelay(received, length, 2, route, out); });
+        BenchResult after = runBench("memcpy + rewriteRelayFields", 200000, [&]
+                                     { benchSink += rewriteForRelay(received, length, 2, route, out); });
+
+        TEST_ASSERT_EQUAL(0, (int)(after.allocations * 100));
+        TEST_ASSERT_TRUE(after.nanos < before.nanos);
+    }
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_ttl_only_matches_rebuild);
+    RUN_TEST(test_route_insertion_matches_rebuild);
+    RUN_TEST(test_route_replacement_matches_rebuild);
+    RUN_TEST(test_frames_that_do_not_fit_are_rejected);
+    RUN_TEST(test_benchmark_relay_rewrite);
+    return UNITY_END();
+}